@@ -14,6 +14,14 @@
 #define IRQ_HIGH       0
 #define IRQ_LOW        1
 
+#define MEM32(addr)         *(volatile unsigned long *)(addr)
+
+#define DEM_CR              0xE000EDFC      // 调试异常及监视控制寄存器
+#define DEM_CR_TRCENA       (1 << 24)       // 使能DWT等跟踪单元
+#define DWT_CR              0xE0001000      // DWT控制寄存器
+#define DWT_CR_CYCCNTENA    (1 << 0)        // 使能周期计数器
+#define DWT_CYCCNT          0xE0001004      // 周期计数器
+
 #ifdef HAL_STM32
     #include <stm32f10x.h>
     #include "stm32f10x_conf.h"
@@ -77,6 +85,23 @@ void targetEnterSleep (void) {
 #endif
 }
 
+/**
+ * 启动DWT周期计数器，用于测量代码的执行周期数
+ */
+void targetCycleInit (void) {
+    MEM32(DEM_CR) |= DEM_CR_TRCENA;
+    MEM32(DWT_CYCCNT) = 0;
+    MEM32(DWT_CR) |= DWT_CR_CYCCNTENA;
+}
+
+/**
+ * 获取当前的CPU周期计数，32位计数，72MHz时约59秒回绕一次
+ * @return 周期计数值
+ */
+uint32_t targetCycleGet (void) {
+    return MEM32(DWT_CYCCNT);
+}
+
 /**
  * 串口发送数据
  * @param ch
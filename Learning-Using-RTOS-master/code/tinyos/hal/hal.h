@@ -12,6 +12,12 @@
 #include "tinyOS.h"
 #include <stdio.h>
 
+// __weak是Keil的关键字。GCC下若在声明处标记weak，应用中的同名定义也会变成弱定义，
+// 所以这里置空，只在hal.c的默认实现处标记
+#if !defined(__CC_ARM) && !defined(__weak)
+    #define __weak
+#endif
+
 enum IRQType {
     IRQ_PRIO_HIGH,                  // 高优先级中断
     IRQ_PRIO_MIDDLE,                // 中优先级中断
@@ -35,6 +41,10 @@ void halInit (void);
 
 void targetEnterSleep (void);
 
+void targetCycleInit (void);
+
+uint32_t targetCycleGet (void);
+
 void interruptByOtherTask (void);
 
 void interruptEnable (enum IRQType irq, int enable);
@@ -12,7 +12,6 @@
  */
 
 #include "tinyOS.h"
-#include "stm32f10x.h"
 
 tTask *currentTask;                             /**< 当前任务：记录当前是哪个任务正在运行 */
 tTask *nextTask;                                /**< 下一个将即运行的任务： */
@@ -24,11 +23,15 @@ tList taskTable[TINYOS_PRO_COUNT];              /**< 所有任务的指针数组
 uint8_t schedLockCount;                         /**< 调度锁计数器 */
 uint32_t tickCount;                             /**< 时钟节拍计数 */
 
-tList tTaskDelayedList;                         /**< 延时队列 */
+tList tTaskDelayedList;                         /**< 延时队列，按唤醒时刻从早到晚排列 */
 
 uint32_t idleCount;                             /**< 空闲任务计数 */
 uint32_t idleMaxCount;                          /**< 空闲任务最大计数 */
 
+#if TINYOS_ENABLE_TICKLESS == 1 && TINYOS_ENABLE_CPUUSAGE_STAT == 1
+#error "CPU usage statistics counts idle loops per tick and can not be used with tickless idle"
+#endif
+
 #if TINYOS_ENABLE_CPUUSAGE_STAT == 1
 static void initCpuUsageStat (void);
 static void checkCpuUsage (void);
@@ -165,8 +168,25 @@ void tTaskDelayedInit (void) {
  * @param ticks   延时的ticks
  */
 void tTimeTaskWait (tTask *task, uint32_t ticks) {
-    task->delayTicks = ticks;
-    tListAddLast(&tTaskDelayedList, &(task->delayNode));
+    tNode *node;
+
+    // 记录唤醒时刻而不是剩余的ticks，节拍中断中就不必再逐个递减
+    // 时刻的比较按有符号差值进行，tickCount回绕后依然正确，但延时不能超过2^31个ticks
+    task->wakeTick = tickCount + ticks;
+
+    // 从尾部向前找到第一个不晚于它唤醒的任务，插在其后面。唤醒时刻相同的任务保持先来后到的顺序
+    for (node = tListLast(&tTaskDelayedList); node != (tNode *) 0; node = tListPre(&tTaskDelayedList, node)) {
+        tTask *delayedTask = tNodeParent(node, tTask, delayNode);
+        if ((int32_t) (delayedTask->wakeTick - task->wakeTick) <= 0) {
+            break;
+        }
+    }
+
+    if (node != (tNode *) 0) {
+        tListInsertAfter(&tTaskDelayedList, node, &(task->delayNode));
+    } else {
+        tListAddFirst(&tTaskDelayedList, &(task->delayNode));
+    }
     task->state |= TINYOS_TASK_STATE_DELAYED;
 }
 
@@ -175,9 +195,6 @@ void tTimeTaskWait (tTask *task, uint32_t ticks) {
  * @param task  需要唤醒的任务
  */
 void tTimeTaskWakeUp (tTask *task) {
-    // 2017-6-28 添加清0操作
-    task->delayTicks = 0;
-
     tListRemove(&tTaskDelayedList, &(task->delayNode));
     task->state &= ~TINYOS_TASK_STATE_DELAYED;
 }
@@ -202,31 +219,31 @@ void tTimeTickInit (void) {
  */
 void tTaskSystemTickHandler (void) {
     tNode *node;
-    uint32_t count;
 
     // 进入临界区，以保护在整个任务调度与切换期间，不会因为发生中断导致currentTask和nextTask可能更改
     uint32_t status = tTaskEnterCritical();
 
-    // 检查所有任务的delayTicks数，如果不0的话，减1。
-    // 2017-9-2：修改访问方式，不涉及细节
-    for (node = tListFirst(&tTaskDelayedList), count = tListCount(&tTaskDelayedList); count > 0; count--) {
-        tTask *task = tNodeParent(node, tTask, delayNode);
-        if (--task->delayTicks == 0) {
-            // 如果任务还处于等待事件的状态，则将其从事件等待队列中唤醒
-            if (task->waitEvent) {
-                // 此时，消息为空，等待结果为超时
-                tEventRemoveTask(task, (void *) 0, tErrorTimeout);
-            }
+    // 节拍计数增加
+    tickCount++;
 
-            // 预先获取下一结点，否则下面的移除会造成问题
-            node = tListNext(&tTaskDelayedList, node);
+    // 延时队列按唤醒时刻排序，只需从头部取出已经到期的任务，遇到第一个未到期的任务即可停止
+    while ((node = tListFirst(&tTaskDelayedList)) != (tNode *) 0) {
+        tTask *task = tNodeParent(node, tTask, delayNode);
+        if ((int32_t) (task->wakeTick - tickCount) > 0) {
+            break;
+        }
 
-            // 将任务从延时队列中移除
-            tTimeTaskWakeUp(task);
+        // 将任务从延时队列中移除
+        tTimeTaskWakeUp(task);
 
-            // 将任务恢复到就绪状态
-            tTaskSchedRdy(task);
+        // 如果任务还处于等待事件的状态，则将其从事件等待队列中唤醒
+        if (task->waitEvent) {
+            // 此时，消息为空，等待结果为超时
+            tEventRemoveTask(task, (void *) 0, tErrorTimeout);
         }
+
+        // 将任务恢复到就绪状态
+        tTaskSchedRdy(task);
     }
 
     // 检查下当前任务的时间片是否已经到了
@@ -243,9 +260,6 @@ void tTaskSystemTickHandler (void) {
         currentTask->slice = TINYOS_SLICE_MAX;
     }
 
-    // 节拍计数增加
-    tickCount++;
-
 #if TINYOS_ENABLE_CPUUSAGE_STAT == 1
     // 检查cpu使用率
     checkCpuUsage();
@@ -263,7 +277,7 @@ void tTaskSystemTickHandler (void) {
     tHooksSysTick();
 #endif
 
-    // 这个过程中可能有任务延时完毕(delayTicks = 0)，进行一次调度。
+    // 这个过程中可能有任务延时完毕，进行一次调度。
     tTaskSched();
 }
 
@@ -288,6 +302,7 @@ static void initCpuUsageStat (void) {
 static void checkCpuUsage (void) {
     // 与空闲任务的cpu统计同步
     if (enableCpuUsageStat == 0) {
+        // 此时调度器仍被锁定，还没有任务进入延时队列，清零不会影响任务的唤醒时刻
         enableCpuUsageStat = 1;
         tickCount = 0;
         return;
@@ -330,6 +345,56 @@ float tCpuUsageGet (void) {
 
 #endif
 
+#if TINYOS_ENABLE_TICKLESS == 1
+
+/**
+ * @brief 无节拍空闲：在最近一个任务或定时器到期之前停止时钟节拍，让CPU休眠
+ */
+static void tTaskTicklessIdle (void) {
+    tNode *node;
+    uint32_t ticks = 0xFFFFFFFF;                // 没有任何需要唤醒的对象时，睡眠时长由tSysTickSleep自行限制
+    uint32_t elapsed;
+
+    // 整个过程都要关中断，否则计算出睡眠时长后，中断中可能又有任务进入延时或启动定时器
+    uint32_t status = tTaskEnterCritical();
+
+    // 延时队列按唤醒时刻排序，头部即最早唤醒的任务
+    node = tListFirst(&tTaskDelayedList);
+    if (node != (tNode *) 0) {
+        tTask *task = tNodeParent(node, tTask, delayNode);
+        int32_t left = (int32_t) (task->wakeTick - tickCount);
+        ticks = (left > 0) ? (uint32_t) left : 0;
+    }
+
+#if TINYOS_ENABLE_TIMER == 1
+    {
+        uint32_t timerTicks = tTimerModuleNextTicks();
+        if (timerTicks < ticks) {
+            ticks = timerTicks;
+        }
+    }
+#endif
+
+    // 下一个节拍就有事要做时，休眠没有意义
+    if (ticks > 1) {
+        // 返回实际经过的整节拍数。如果一直睡到了最后，最后一个节拍由挂起的节拍中断在退出临界区后照常处理
+        elapsed = tSysTickSleep(ticks);
+        if (elapsed > 0) {
+            // 延时队列中记录的是唤醒时刻，只需补上节拍计数，任务的延时自然得到补偿。
+            // 跳过的节拍中不会有任务或定时器到期，所以也不会错过调度
+            tickCount += elapsed;
+
+#if TINYOS_ENABLE_TIMER == 1
+            tTimerModuleTickSkip(elapsed);
+#endif
+        }
+    }
+
+    tTaskExitCritical(status);
+}
+
+#endif
+
 tTask tTaskIdle;                                            /**< 空闲任务结构 */
 tTaskStack idleTaskEnv[TINYOS_IDLETASK_STACK_SIZE];         /**< 空闲任务堆栈 */
 
@@ -365,6 +430,10 @@ void idleTaskEntry (void *param) {
         idleCount++;
         tTaskExitCritical(status);
 
+#if TINYOS_ENABLE_TICKLESS == 1
+        tTaskTicklessIdle();
+#endif
+
 #if TINYOS_ENABLE_HOOKS == 1
         tHooksCpuIdle();
 #endif
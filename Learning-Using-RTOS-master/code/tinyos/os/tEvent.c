@@ -84,7 +84,7 @@ tTask *tEventWakeUp (tEvent *event, void *msg, uint32_t result) {
         task->state &= ~TINYOS_TASK_WAIT_MASK;
 
         // 任务申请了超时等待，这里检查下，将其从延时队列中移除
-        if (task->delayTicks != 0) {
+        if (task->state & TINYOS_TASK_STATE_DELAYED) {
             tTimeTaskWakeUp(task);
         }
 
@@ -119,7 +119,7 @@ void tEventWakeUpTask (tEvent *event, tTask *task, void *msg, uint32_t result) {
     task->state &= ~TINYOS_TASK_WAIT_MASK;
 
     // 任务申请了超时等待，这里检查下，将其从延时队列中移除
-    if (task->delayTicks != 0) {
+    if (task->state & TINYOS_TASK_STATE_DELAYED) {
         tTimeTaskWakeUp(task);
     }
 
@@ -182,7 +182,7 @@ uint32_t tEventRemoveAll (tEvent *event, void *msg, uint32_t result) {
         task->state &= ~TINYOS_TASK_WAIT_MASK;
 
         // 任务申请了超时等待，这里检查下，将其从延时队列中移除
-        if (task->delayTicks != 0) {
+        if (task->state & TINYOS_TASK_STATE_DELAYED) {
             tTimeTaskWakeUp(task);
         }
 
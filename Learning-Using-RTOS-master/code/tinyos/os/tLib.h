@@ -9,6 +9,7 @@
 #define TLIB_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 /**
  * @defgroup 位图结构 位图结构
@@ -45,7 +46,8 @@ typedef struct _tList {
     uint32_t nodeCount;
 } tList;
 
-#define tNodeParent(node, parent, name) (parent *)((uint32_t)node - (uint32_t)&((parent *)0)->name)
+// 由结点地址反推其所在的结构地址。按字节指针计算，在64位平台上也不会截断地址
+#define tNodeParent(node, parent, name) ((parent *)((char *)(node) - offsetof(parent, name)))
 
 void tListInit (tList *list);
 uint32_t tListCount (tList *list);
@@ -79,6 +79,40 @@ uint32_t saveAndLoadStackAddr (uint32_t stackAddr) {
     return (uint32_t)currentTask->stack;
 }
 
+/**
+ * 为从未运行过的任务构造一个“虚假的”保存现场，使其能够像被切换出去的任务一样被恢复运行
+ * @param stack 任务堆栈的起始地址
+ * @param size 任务堆栈的字节数
+ * @param entry 任务的入口函数
+ * @param param 传递给任务的运行参数
+ * @return 构造完毕后的栈顶，即任务初始的stack值
+ */
+uint32_t *tTaskStackInit (uint32_t *stack, uint32_t size, void (*entry) (void *), void *param) {
+    uint32_t *stackTop = stack + size / sizeof(tTaskStack);
+
+    // 注意以下两点：
+    // 1、不需要用到的寄存器，直接填了寄存器号，方便在IDE调试时查看效果；
+    // 2、顺序不能变，要结合PendSV_Handler以及CPU对异常的处理流程来理解
+    *(--stackTop) = (unsigned long) (1 << 24);               // XPSR, 设置了Thumb模式，恢复到Thumb状态而非ARM状态运行
+    *(--stackTop) = (unsigned long) entry;                  // 程序的入口地址
+    *(--stackTop) = (unsigned long) 0x14;                   // R14(LR), 任务不会通过return xxx结束自己，所以未用
+    *(--stackTop) = (unsigned long) 0x12;                   // R12, 未用
+    *(--stackTop) = (unsigned long) 0x3;                    // R3, 未用
+    *(--stackTop) = (unsigned long) 0x2;                    // R2, 未用
+    *(--stackTop) = (unsigned long) 0x1;                    // R1, 未用
+    *(--stackTop) = (unsigned long) param;                  // R0 = param, 传给任务的入口函数
+    *(--stackTop) = (unsigned long) 0x11;                   // R11, 未用
+    *(--stackTop) = (unsigned long) 0x10;                   // R10, 未用
+    *(--stackTop) = (unsigned long) 0x9;                    // R9, 未用
+    *(--stackTop) = (unsigned long) 0x8;                    // R8, 未用
+    *(--stackTop) = (unsigned long) 0x7;                    // R7, 未用
+    *(--stackTop) = (unsigned long) 0x6;                    // R6, 未用
+    *(--stackTop) = (unsigned long) 0x5;                    // R5, 未用
+    *(--stackTop) = (unsigned long) 0x4;                    // R4, 未用
+
+    return stackTop;
+}
+
 /**
  * 在启动tinyOS时，调用该函数，将切换至第一个任务运行
  */
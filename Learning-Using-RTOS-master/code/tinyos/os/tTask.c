@@ -12,6 +12,7 @@
  */
 
 
+#include <string.h>
 #include "tinyOS.h"
 
 /**
@@ -31,26 +32,8 @@ void tTaskInit (tTask *task, void (*entry) (void *), void *param, uint32_t prio,
     task->stackSize = size;
     memset(stack, 0, size);
 
-    // 注意以下两点：
-    // 1、不需要用到的寄存器，直接填了寄存器号，方便在IDE调试时查看效果；
-    // 2、顺序不能变，要结合PendSV_Handler以及CPU对异常的处理流程来理解
-    stackTop = stack + size / sizeof(tTaskStack);
-    *(--stackTop) = (unsigned long) (1 << 24);               // XPSR, 设置了Thumb模式，恢复到Thumb状态而非ARM状态运行
-    *(--stackTop) = (unsigned long) entry;                  // 程序的入口地址
-    *(--stackTop) = (unsigned long) 0x14;                   // R14(LR), 任务不会通过return xxx结束自己，所以未用
-    *(--stackTop) = (unsigned long) 0x12;                   // R12, 未用
-    *(--stackTop) = (unsigned long) 0x3;                    // R3, 未用
-    *(--stackTop) = (unsigned long) 0x2;                    // R2, 未用
-    *(--stackTop) = (unsigned long) 0x1;                    // R1, 未用
-    *(--stackTop) = (unsigned long) param;                  // R0 = param, 传给任务的入口函数
-    *(--stackTop) = (unsigned long) 0x11;                   // R11, 未用
-    *(--stackTop) = (unsigned long) 0x10;                   // R10, 未用
-    *(--stackTop) = (unsigned long) 0x9;                    // R9, 未用
-    *(--stackTop) = (unsigned long) 0x8;                    // R8, 未用
-    *(--stackTop) = (unsigned long) 0x7;                    // R7, 未用
-    *(--stackTop) = (unsigned long) 0x6;                    // R6, 未用
-    *(--stackTop) = (unsigned long) 0x5;                    // R5, 未用
-    *(--stackTop) = (unsigned long) 0x4;                    // R4, 未用
+    // 初始现场的具体布局与处理器相关，由移植层负责填写
+    stackTop = tTaskStackInit(stack, size, entry, param);
 
     task->slice = TINYOS_SLICE_MAX;                     // 初始化任务的时间片计数
     task->stack = stackTop;                             // 保存最终的值
@@ -245,7 +228,7 @@ void tTaskGetInfo (tTask *task, tTaskInfo *info) {
     // 进入临界区
     uint32_t status = tTaskEnterCritical();
 
-    info->delayTicks = task->delayTicks;                // 延时信息
+    info->delayTicks = (task->state & TINYOS_TASK_STATE_DELAYED) ? task->wakeTick - tickCount : 0;   // 剩余的延时
     info->prio = task->prio;                            // 任务优先级
     info->state = task->state;                          // 任务状态
     info->slice = task->slice;                          // 剩余时间片
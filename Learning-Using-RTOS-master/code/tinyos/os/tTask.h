@@ -39,7 +39,7 @@ typedef struct _tTask {
     uint32_t stackSize;                 /**< 堆栈的总容量 */
     tNode linkNode;                     /**< 连接结点 */
 
-    uint32_t delayTicks;                /**< 任务延时计数器 */
+    uint32_t wakeTick;                  /**< 延时到期时的tickCount值 */
     tNode delayNode;                    /**< 延时结点：通过delayNode就可以将tTask放置到延时队列中 */
 
     uint32_t prio;                      /**< 任务的优先级 */
@@ -21,14 +21,14 @@ void tTaskDelay (uint32_t delay) {
     // 进入临界区，以保护在整个任务调度与切换期间，不会因为发生中断导致currentTask和nextTask可能更改
     uint32_t status = tTaskEnterCritical();
 
-    // 设置延时值，插入延时队列
+    // 记下到期时的wakeTick，按wakeTick从早到晚插入延时队列
     tTimeTaskWait(currentTask, delay);
 
     // 将任务从就绪表中移除
     tTaskSchedUnRdy(currentTask);
 
     // 然后进行任务切换，切换至另一个任务，或者空闲任务
-    // delayTikcs会在时钟中断中自动减1.当减至0时，会切换回来继续运行。
+    // 时钟中断只检查延时队列头部，tickCount到达wakeTick时将任务唤醒，会切换回来继续运行。
     tTaskSched();
 
     // 退出临界区
@@ -16,10 +16,26 @@
 
 #if !defined(TINYOS_ENABLE_TIMER) || TINYOS_ENABLE_TIMER == 1
 
-static tList tTimerHardList;                    // "硬"定时器列表
-static tList tTimerSoftList;                    // "软"定时器列表
-static tSem tTimerProtectSem;                   // 用于访问软定时器列表的信号量
+// 分层时间轮：第0层每个槽对应1个节拍，往上每层每个槽对应的节拍数是下一层的TIMER_WHEEL_SLOTS倍。
+// 启动、停止定时器只是将其加入或移出某个槽，每个节拍只处理第0层的一个槽，
+// 低层转完一圈时再将高层下一个槽中的定时器重新分配到低层
+#define TIMER_WHEEL_BITS                4
+#define TIMER_WHEEL_SLOTS               (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK                (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS              3
+
+// 定时器时间轮
+typedef struct _tTimerWheel {
+    uint32_t tick;                                          // 已经处理过的节拍数
+    tList slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];     // 各层的槽
+    tList overflow;                                         // 超出最高层范围的定时器，最高层转完一圈时重新分配
+} tTimerWheel;
+
+static tTimerWheel tTimerHardWheel;             // "硬"定时器时间轮，在时钟节拍中断中推进
+static tTimerWheel tTimerSoftWheel;             // "软"定时器时间轮，在定时器任务中推进
+static tSem tTimerProtectSem;                   // 用于访问软定时器时间轮的信号量
 static tSem tTimerTickSem;                      // 用于软定时器任务与中断同步的计数信号量
+static tTask tTimeTask;                         // 推进软定时器时间轮的任务
 
 /**
  * 初始化定时器
@@ -36,17 +52,79 @@ void tTimerInit (tTimer *timer, uint32_t delayTicks, uint32_t durationTicks,
     tNodeInit(&timer->linkNode);
     timer->startDelayTicks = delayTicks;
     timer->durationTicks = durationTicks;
+    timer->expireTick = 0;
+    timer->wheelList = (tList *) 0;
     timer->timerFunc = timerFunc;
     timer->arg = arg;
     timer->config = config;
+    timer->state = tTimerCreated;
+}
 
-    // 如果初始启动延时为0，则使用周期值
-    if (delayTicks == 0) {
-        timer->delayTicks = durationTicks;
-    } else {
-        timer->delayTicks = timer->startDelayTicks;
+/**
+ * 按到期时刻将定时器放入时间轮中相应的槽
+ * @param wheel 时间轮
+ * @param timer 定时器
+ */
+static void tTimerWheelAdd (tTimerWheel *wheel, tTimer *timer) {
+    uint32_t ticks = timer->expireTick - wheel->tick;
+    tList *list = &wheel->overflow;
+    uint32_t level;
+
+    // 找到能容纳该时长的最低一层，按到期时刻在这一层中对应的位选择槽
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if (ticks < (1UL << (TIMER_WHEEL_BITS * (level + 1)))) {
+            list = &wheel->slots[level][(timer->expireTick >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK];
+            break;
+        }
+    }
+
+    tListAddLast(list, &timer->linkNode);
+    timer->wheelList = list;
+}
+
+/**
+ * 将定时器从所在的时间轮槽中移除
+ * @param timer 定时器
+ */
+static void tTimerWheelRemove (tTimer *timer) {
+    // 正在执行回调的定时器已经不在槽中
+    if (timer->wheelList != (tList *) 0) {
+        tListRemove(timer->wheelList, &timer->linkNode);
+        timer->wheelList = (tList *) 0;
+    }
+}
+
+/**
+ * 将某个槽中的定时器按剩余时长重新分配
+ * @param wheel 时间轮
+ * @param list 重新分配的槽
+ */
+static void tTimerWheelCascade (tTimerWheel *wheel, tList *list) {
+    uint32_t count;
+
+    // 只处理原有的定时器，仍然放回该槽的不会被再次处理
+    for (count = tListCount(list); count > 0; count--) {
+        tNode *node = tListRemoveFirst(list);
+        tTimerWheelAdd(wheel, tNodeParent(node, tTimer, linkNode));
+    }
+}
+
+/**
+ * 获取软定时器时间轮的访问权限。软定时器的回调函数在定时器任务中执行，此时已持有该权限，不能再等待
+ */
+static void tTimerSoftLock (void) {
+    if (currentTask != &tTimeTask) {
+        tSemWait(&tTimerProtectSem, 0);
+    }
+}
+
+/**
+ * 释放软定时器时间轮的访问权限
+ */
+static void tTimerSoftUnlock (void) {
+    if (currentTask != &tTimeTask) {
+        tSemNotify(&tTimerProtectSem);
     }
-    timer->state = tTimerCreated;
 }
 
 /**
@@ -56,26 +134,33 @@ void tTimerInit (tTimer *timer, uint32_t delayTicks, uint32_t durationTicks,
 void tTimerStart (tTimer *timer) {
     switch (timer->state) {
         case tTimerCreated:
-        case tTimerStopped:
-            timer->delayTicks = timer->startDelayTicks ? timer->startDelayTicks : timer->durationTicks;
+        case tTimerStopped: {
+            // 如果初始启动延时为0，则使用周期值。两者都为0时在下一个节拍到期
+            uint32_t delayTicks = timer->startDelayTicks ? timer->startDelayTicks : timer->durationTicks;
+            if (delayTicks == 0) {
+                delayTicks = 1;
+            }
             timer->state = tTimerStarted;
 
-            // 根据定时器类型加入相应的定时器列表
+            // 根据定时器类型加入相应的时间轮，到期时刻以该时间轮已处理的节拍为起点
             if (timer->config & TIMER_CONFIG_TYPE_HARD) {
                 // 硬定时器，在时钟节拍中断中处理，所以使用critical来防护
                 uint32_t status = tTaskEnterCritical();
 
-                // 加入硬定时器列表
-                tListAddLast(&tTimerHardList, &timer->linkNode);
+                // 加入硬定时器时间轮
+                timer->expireTick = tTimerHardWheel.tick + delayTicks;
+                tTimerWheelAdd(&tTimerHardWheel, timer);
 
                 tTaskExitCritical(status);
             } else {
-                // 软定时器，先获取信号量。以处理此时定时器任务此时同时在访问软定时器列表导致的冲突问题
-                tSemWait(&tTimerProtectSem, 0);
-                tListAddLast(&tTimerSoftList, &timer->linkNode);
-                tSemNotify(&tTimerProtectSem);
+                // 软定时器，先获取信号量。以处理此时定时器任务此时同时在访问软定时器时间轮导致的冲突问题
+                tTimerSoftLock();
+                timer->expireTick = tTimerSoftWheel.tick + delayTicks;
+                tTimerWheelAdd(&tTimerSoftWheel, timer);
+                tTimerSoftUnlock();
             }
             break;
+        }
         default:
             break;
     }
@@ -89,20 +174,20 @@ void tTimerStop (tTimer *timer) {
     switch (timer->state) {
         case tTimerStarted:
         case tTimerRunning:
-            // 如果已经启动，判断定时器类型，然后从相应的延时列表中移除
+            // 如果已经启动，判断定时器类型，然后从相应的时间轮中移除
             if (timer->config & TIMER_CONFIG_TYPE_HARD) {
                 // 硬定时器，在时钟节拍中断中处理，所以使用critical来防护
                 uint32_t status = tTaskEnterCritical();
 
-                // 从硬定时器列表中移除
-                tListRemove(&tTimerHardList, &timer->linkNode);
+                // 从硬定时器时间轮中移除
+                tTimerWheelRemove(timer);
 
                 tTaskExitCritical(status);
             } else {
-                // 软定时器，先获取信号量。以处理此时定时器任务此时同时在访问软定时器列表导致的冲突问题
-                tSemWait(&tTimerProtectSem, 0);
-                tListRemove(&tTimerSoftList, &timer->linkNode);
-                tSemNotify(&tTimerProtectSem);
+                // 软定时器，先获取信号量。以处理此时定时器任务此时同时在访问软定时器时间轮导致的冲突问题
+                tTimerSoftLock();
+                tTimerWheelRemove(timer);
+                tTimerSoftUnlock();
             }
             timer->state = tTimerStopped;
             break;
@@ -139,45 +224,61 @@ void tTimerGetInfo (tTimer *timer, tTimerInfo *info) {
 }
 
 /**
- * 遍历指定的定时器列表，调用各个定时器处理函数
+ * 将时间轮推进一个节拍，调用到期的定时器处理函数
+ * @param wheel 推进的时间轮
  */
-static void tTimerCallFuncList (tList *timerList) {
+static void tTimerWheelTick (tTimerWheel *wheel) {
+    tList *slot;
     tNode *node;
-		uint32_t count;
+    uint32_t level;
+
+    wheel->tick++;
+
+    // 低层转完一圈时，高层的下一个槽中的定时器已进入低层的范围，将其重新分配
+    for (level = 1; level <= TIMER_WHEEL_LEVELS; level++) {
+        if (wheel->tick & ((1UL << (TIMER_WHEEL_BITS * level)) - 1)) {
+            break;
+        }
+
+        if (level < TIMER_WHEEL_LEVELS) {
+            tTimerWheelCascade(wheel, &wheel->slots[level][(wheel->tick >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK]);
+        } else {
+            tTimerWheelCascade(wheel, &wheel->overflow);
+        }
+    }
 
-		for (node = tListFirst(timerList), count = tListCount(timerList); count > 0; count--) {
-    // 检查所有任务的delayTicks数，如果不0的话，减1。
+    // 第0层当前槽中的定时器都在这个节拍到期
+    slot = &wheel->slots[0][wheel->tick & TIMER_WHEEL_MASK];
+    while ((node = tListRemoveFirst(slot)) != (tNode *) 0) {
         tTimer *timer = tNodeParent(node, tTimer, linkNode);
+        timer->wheelList = (tList *) 0;
 
-        // 如果延时已到，则调用定时器处理函数
-        if ((timer->delayTicks == 0) || (--timer->delayTicks == 0)) {
-            // 切换为正在运行状态
-            timer->state = tTimerRunning;
+        // 切换为正在运行状态
+        timer->state = tTimerRunning;
 
-            // 调用定时器处理函数
-            timer->timerFunc(timer->arg);
+        // 调用定时器处理函数
+        timer->timerFunc(timer->arg);
 
-            // 切换为已经启动状态
-            timer->state = tTimerStarted;
+        // 回调函数中可能已经停止了该定时器
+        if (timer->state != tTimerRunning) {
+            continue;
+        }
 
-            if (timer->durationTicks > 0) {
-                // 如果是周期性的，则重复延时计数值
-                timer->delayTicks = timer->durationTicks;
-            } else {
-                // 否则，是一次性计数器，中止定时器
-                tListRemove(timerList, &timer->linkNode);
-                timer->state = tTimerStopped;
-            }
+        if (timer->durationTicks > 0) {
+            // 如果是周期性的，则按周期计算下一次的到期时刻
+            timer->state = tTimerStarted;
+            timer->expireTick += timer->durationTicks;
+            tTimerWheelAdd(wheel, timer);
+        } else {
+            // 否则，是一次性计数器，中止定时器
+            timer->state = tTimerStopped;
         }
-				
-				node = tListNext(timerList, node);
     }
 }
 
 /**
- * 处理软定时器列表的任务
+ * 推进软定时器时间轮的任务
  */
-static tTask tTimeTask;
 static tTaskStack tTimerTaskStack[TINYOS_TIMERTASK_STACK_SIZE];
 
 static void tTimerSoftTask (void *param) {
@@ -185,13 +286,13 @@ static void tTimerSoftTask (void *param) {
         // 等待系统节拍发送的中断事件信号
         tSemWait(&tTimerTickSem, 0);
 
-        // 获取软定时器列表的访问权限
+        // 获取软定时器时间轮的访问权限
         tSemWait(&tTimerProtectSem, 0);
 
-        // 处理软定时器列表
-        tTimerCallFuncList(&tTimerSoftList);
+        // 推进软定时器时间轮
+        tTimerWheelTick(&tTimerSoftWheel);
 
-        // 释放定时器列表访问权限
+        // 释放定时器时间轮访问权限
         tSemNotify(&tTimerProtectSem);
     }
 }
@@ -202,8 +303,8 @@ static void tTimerSoftTask (void *param) {
 void tTimerModuleTickNotify (void) {
     uint32_t status = tTaskEnterCritical();
 
-    // 处理硬定时器列表
-    tTimerCallFuncList(&tTimerHardList);
+    // 推进硬定时器时间轮
+    tTimerWheelTick(&tTimerHardWheel);
 
     tTaskExitCritical(status);
 
@@ -211,12 +312,87 @@ void tTimerModuleTickNotify (void) {
     tSemNotify(&tTimerTickSem);
 }
 
+/**
+ * 获取槽中的定时器最早还需要多少个节拍到期
+ */
+static uint32_t tTimerListNextTicks (tTimerWheel *wheel, tList *list, uint32_t ticks) {
+    tNode *node;
+
+    for (node = tListFirst(list); node != (tNode *) 0; node = tListNext(list, node)) {
+        tTimer *timer = tNodeParent(node, tTimer, linkNode);
+
+        uint32_t left = timer->expireTick - wheel->tick;
+        if (left < ticks) {
+            ticks = left;
+        }
+    }
+    return ticks;
+}
+
+/**
+ * 获取时间轮中的定时器最早还需要多少个节拍到期
+ */
+static uint32_t tTimerWheelNextTicks (tTimerWheel *wheel, uint32_t ticks) {
+    uint32_t level, index;
+
+    // 同一层中，从当前位置往后先遇到的槽先到期，所以每层只需查看第一个非空的槽
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        uint32_t current = (wheel->tick >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+
+        for (index = 1; index <= TIMER_WHEEL_SLOTS; index++) {
+            tList *slot = &wheel->slots[level][(current + index) & TIMER_WHEEL_MASK];
+            if (tListCount(slot) > 0) {
+                ticks = tTimerListNextTicks(wheel, slot, ticks);
+                break;
+            }
+        }
+    }
+    return tTimerListNextTicks(wheel, &wheel->overflow, ticks);
+}
+
+/**
+ * 获取最近一个定时器到期前还有多少个节拍，供无节拍空闲模式计算休眠时长。需在临界区中调用
+ * @return 节拍数，没有已启动的定时器时返回0xFFFFFFFF
+ */
+uint32_t tTimerModuleNextTicks (void) {
+    uint32_t ticks = tTimerWheelNextTicks(&tTimerHardWheel, 0xFFFFFFFF);
+    return tTimerWheelNextTicks(&tTimerSoftWheel, ticks);
+}
+
+/**
+ * 补偿无节拍空闲期间跳过的节拍。调用者保证这些节拍中没有定时器到期，需在临界区中调用
+ * @param ticks 跳过的节拍数
+ */
+void tTimerModuleTickSkip (uint32_t ticks) {
+    // 跳过的节拍中不会调用定时器处理函数，逐个节拍推进时间轮只是完成其中的重新分配。
+    // 软定时器时间轮受tTimerProtectSem保护，这里不能等待，所以补发节拍信号，仍由定时器任务推进
+    while (ticks-- > 0) {
+        tTimerWheelTick(&tTimerHardWheel);
+        tSemNotify(&tTimerTickSem);
+    }
+}
+
+/**
+ * 初始化定时器时间轮
+ */
+static void tTimerWheelInit (tTimerWheel *wheel) {
+    uint32_t level, index;
+
+    wheel->tick = 0;
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (index = 0; index < TIMER_WHEEL_SLOTS; index++) {
+            tListInit(&wheel->slots[level][index]);
+        }
+    }
+    tListInit(&wheel->overflow);
+}
+
 /**
  * 定时器模块初始化
  */
 void tTimerModuleInit (void) {
-    tListInit(&tTimerHardList);
-    tListInit(&tTimerSoftList);
+    tTimerWheelInit(&tTimerHardWheel);
+    tTimerWheelInit(&tTimerSoftWheel);
     tSemInit(&tTimerProtectSem, 1, 1);
     tSemInit(&tTimerTickSem, 0, 0);
 }
@@ -35,7 +35,8 @@ typedef struct _tTimer {
 
     uint32_t startDelayTicks;           /**< 初次启动延后的ticks数 */
     uint32_t durationTicks;             /**< 周期定时时的周期tick数 */
-    uint32_t delayTicks;                /**< 当前定时递减计数值 */
+    uint32_t expireTick;                /**< 到期时刻，以所在时间轮的节拍计 */
+    tList *wheelList;                   /**< 所在的时间轮槽，未启动或正在回调时为0 */
 
     void (*timerFunc) (void *arg);      /**< 定时回调函数 */
     void *arg;                          /**< 传递给回调函数的参数 */
@@ -69,6 +70,8 @@ void tTimerStop (tTimer *timer);
 void tTimerDestroy (tTimer *timer);
 void tTimerGetInfo (tTimer *timer, tTimerInfo *info);
 void tTimerModuleTickNotify (void);
+uint32_t tTimerModuleNextTicks (void);
+void tTimerModuleTickSkip (uint32_t ticks);
 void tTimerModuleInit (void);
 void tTimerInitTask (void);
 tTask * tTimerTask (void);
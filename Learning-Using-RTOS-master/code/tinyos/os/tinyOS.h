@@ -45,11 +45,15 @@ extern tTask *currentTask;
 //! 下一个将即运行的任务：在进行任务切换前，先设置好该值，然后任务切换过程中会从中读取下一任务信息
 extern tTask *nextTask;
 
+//! 时钟节拍计数：每个节拍加1，延时队列按它计算任务的唤醒时刻
+extern uint32_t tickCount;
+
 typedef uint32_t tTaskCritical_t;
 
 tTaskCritical_t tTaskEnterCritical (void);
 void tTaskExitCritical (tTaskCritical_t status);
 
+uint32_t *tTaskStackInit (uint32_t *stack, uint32_t size, void (*entry) (void *), void *param);
 void tTaskRunFirst (void);
 
 void tTaskSwitch (void);
@@ -71,6 +75,7 @@ void tTaskSystemTickHandler (void);
 
 void tInitApp (void);
 void tSetSysTickPeriod (uint32_t ms);
+uint32_t tSysTickSleep (uint32_t ticks);
 float tCpuUsageGet (void);
 tTask * tIdleTask (void);
 
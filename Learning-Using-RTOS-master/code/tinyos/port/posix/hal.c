@@ -0,0 +1,183 @@
+/**
+ * @brief tOS 目标相关配置代码，POSIX主机版本
+ * @details 外部中断用实时信号模拟，优先级关系与STM32版本的NVIC配置一致
+ * @author 01课堂 李述铜 http://01ketang.cc
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+#include "tinyOS.h"
+#include "tPort.h"
+
+#include "hal.h"
+
+#if TINYOS_ENABLE_MUTEX == 1
+    tMutex xprintfMutex;
+#endif
+
+static volatile sig_atomic_t irqEnabled[TINYOS_PORT_IRQ_COUNT];     // 中断是否已使能，相当于NVIC的使能位
+static volatile sig_atomic_t irqPending[TINYOS_PORT_IRQ_COUNT];     // 未使能期间触发的中断，相当于NVIC的挂起位
+
+/**
+ * 中断信号的处理函数，分发到各个中断处理函数
+ */
+static void irqHandler (int sig) {
+    int irq = sig - TINYOS_PORT_SIG_IRQ(0);
+
+    if (!irqEnabled[irq]) {
+        irqPending[irq] = 1;
+        return;
+    }
+
+    switch (irq) {
+        case IRQ_PRIO_HIGH:
+            IRQHighHandler();
+            break;
+        case IRQ_PRIO_MIDDLE:
+            IRQMiddleHandler();
+            break;
+        case IRQ_PRIO_LOW:
+            IRQLowHandler();
+            break;
+    }
+}
+
+/*
+ * 初始化中断配置
+ */
+void interruptInit (void) {
+    struct sigaction action;
+    int irq, masked;
+
+    // 处理某个中断时，屏蔽它自己及所有比它优先级低的中断，包括时钟节拍和任务切换，
+    // 这样高优先级的中断仍然可以嵌套进来
+    for (irq = 0; irq < TINYOS_PORT_IRQ_COUNT; irq++) {
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = irqHandler;
+        sigemptyset(&action.sa_mask);
+        sigaddset(&action.sa_mask, TINYOS_PORT_SIG_TICK);
+        sigaddset(&action.sa_mask, TINYOS_PORT_SIG_PENDSV);
+        for (masked = irq; masked < TINYOS_PORT_IRQ_COUNT; masked++) {
+            sigaddset(&action.sa_mask, TINYOS_PORT_SIG_IRQ(masked));
+        }
+        action.sa_flags = SA_RESTART;
+        sigaction(TINYOS_PORT_SIG_IRQ(irq), &action, (struct sigaction *) 0);
+    }
+}
+
+/**
+ * 进入低功耗模式，直到下一个中断到来
+ */
+void targetEnterSleep (void) {
+    pause();
+}
+
+/**
+ * 启动周期计数器。主机上直接使用时间戳计数器，不需要初始化
+ */
+void targetCycleInit (void) {
+}
+
+/**
+ * 获取当前的周期计数：x86上为rdtsc的低32位，其它平台为以ns为单位的单调时间
+ * @return 周期计数值
+ */
+uint32_t targetCycleGet (void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t) __rdtsc();
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t) ((uint64_t) now.tv_sec * 1000000000u + now.tv_nsec);
+#endif
+}
+
+/**
+ * 通过延迟切换到其它任务，以模拟任务被突然强制中断的情况
+ */
+void interruptByOtherTask (void) {
+    tTaskDelay(1);
+}
+
+/**
+ * 使能指定的中断
+ * @param irq 使能的中断序号
+ */
+void interruptEnable (enum IRQType irq, int enable) {
+    irqEnabled[irq] = enable;
+
+    // 与NVIC一样，使能之前已挂起的中断会在使能后立即得到处理
+    if (enable && irqPending[irq]) {
+        irqPending[irq] = 0;
+        raise(TINYOS_PORT_SIG_IRQ(irq));
+    }
+}
+
+/**
+ * 主动触发一个中断。在临界区中触发时，信号被屏蔽而处于挂起状态，退出临界区后才处理
+ */
+void interruptByIRQ (enum IRQType irq) {
+    raise(TINYOS_PORT_SIG_IRQ(irq));
+}
+
+/**
+ * 中断处理函数
+ */
+__attribute__((weak)) void IRQHighHandler (void) {
+
+}
+
+/**
+ * 中断处理函数
+ */
+__attribute__((weak)) void IRQMiddleHandler (void) {
+
+}
+
+/**
+ * 中断处理函数
+ */
+__attribute__((weak)) void IRQLowHandler (void) {
+
+}
+
+/**
+ * 以十六进制打印一段存储区
+ * @param mem 存储区起始地址
+ * @param size 存储区字节数
+ */
+void xprintfMem (uint8_t *mem, uint32_t size) {
+    uint32_t i;
+    uint32_t column = 0;
+
+    for (i = 0; i < size; i++) {
+        if (++column % 8 == 0) {
+            xprintf("0x%x\n", mem[i]);
+        } else {
+            xprintf("0x%x,", mem[i]);
+        }
+    }
+    xprintf("\n");
+}
+
+/**
+ * 初始化目标设备
+ */
+void halInit (void) {
+    // 标准输出不缓冲，以便与Keil中通过串口输出的效果相同
+    setvbuf(stdout, (char *) 0, _IONBF, 0);
+
+#if TINYOS_ENABLE_MUTEX == 1
+    tMutexInit(&xprintfMutex);
+#endif
+
+    interruptInit();
+}
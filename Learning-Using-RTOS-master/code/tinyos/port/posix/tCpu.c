@@ -0,0 +1,121 @@
+/**
+ * @brief tinyOS 与处理器相关配置，POSIX主机版本
+ * @author 01课堂 李述铜 http://01ketang.cc
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#include <string.h>
+#include <sys/time.h>
+#include "tinyOS.h"
+#include "tPort.h"
+
+static uint64_t sysTickUs;                      // 节拍周期，以us为单位
+
+/**
+ * 将以us为单位的时长转换为timeval
+ */
+static struct timeval usToTimeval (uint64_t us) {
+    struct timeval value;
+
+    value.tv_sec = us / 1000000;
+    value.tv_usec = us % 1000000;
+    return value;
+}
+
+/**
+ * 时钟节拍信号的处理函数，相当于SysTick_Handler
+ */
+static void sysTickHandler (int sig) {
+    (void) sig;
+    tTaskSystemTickHandler();
+}
+
+/**
+ * 系统时钟节拍定时器配置
+ * 主机上使用ITIMER_REAL按实际时间周期性地产生SIGALRM，作为时钟节拍中断
+ */
+void tSetSysTickPeriod (uint32_t ms) {
+    struct sigaction action;
+    struct itimerval timer;
+
+    sysTickUs = (uint64_t) ms * 1000;
+
+    // 与SysTick一样设为最低优先级：处理期间只屏蔽节拍自身及任务切换，外部中断仍可打断它
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = sysTickHandler;
+    sigemptyset(&action.sa_mask);
+    sigaddset(&action.sa_mask, TINYOS_PORT_SIG_TICK);
+    sigaddset(&action.sa_mask, TINYOS_PORT_SIG_PENDSV);
+    action.sa_flags = SA_RESTART;
+    sigaction(TINYOS_PORT_SIG_TICK, &action, (struct sigaction *) 0);
+
+    timer.it_interval = usToTimeval(sysTickUs);
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_REAL, &timer, (struct itimerval *) 0);
+}
+
+/**
+ * 无节拍空闲模式下的休眠：将定时器改为ticks个节拍后到期，等待任一中断信号，醒来后恢复为周期性节拍
+ * 调用时中断信号已被屏蔽，相当于关中断后执行WFI：中断处理函数在调用者退出临界区后才执行
+ * @param ticks 最长休眠的节拍数
+ * @return 休眠期间经过的完整节拍数。如果睡到了最后，节拍信号已挂起，最后一个节拍由它处理，不计入返回值
+ */
+uint32_t tSysTickSleep (uint32_t ticks) {
+    struct itimerval timer, stop;
+    sigset_t set;
+    uint64_t since, sleepUs, leftUs, nextUs;
+    uint32_t elapsed;
+    int sig;
+
+    if (ticks > TINYOS_PORT_SLEEP_MAX_TICKS) {
+        ticks = TINYOS_PORT_SLEEP_MAX_TICKS;
+    }
+
+    // 节拍信号已经挂起时，下面无法分辨它是否属于本次休眠，不睡
+    sigpending(&set);
+    if (sigismember(&set, TINYOS_PORT_SIG_TICK)) {
+        return 0;
+    }
+
+    // 当前节拍中剩余的时间也计入休眠时长，到期时刻正好落在第ticks个节拍边界上。
+    // 到期后定时器按it_interval自动恢复为周期性节拍
+    getitimer(ITIMER_REAL, &timer);
+    leftUs = (uint64_t) timer.it_value.tv_sec * 1000000 + timer.it_value.tv_usec;
+    sleepUs = leftUs + sysTickUs * (ticks - 1);
+    since = sysTickUs - leftUs;                 // 从上一个节拍边界到现在的时长
+    timer.it_value = usToTimeval(sleepUs);
+    timer.it_interval = usToTimeval(sysTickUs);
+    setitimer(ITIMER_REAL, &timer, (struct itimerval *) 0);
+
+    // sigwaitinfo会取走收到的信号，再发送一次让它保持挂起，退出临界区后照常处理
+    tPortInterruptSet(&set);
+    while ((sig = sigwaitinfo(&set, (siginfo_t *) 0)) < 0) {
+    }
+    raise(sig);
+
+    // 停下定时器，读出剩余时间
+    memset(&stop, 0, sizeof(stop));
+    setitimer(ITIMER_REAL, &stop, &timer);
+    leftUs = (uint64_t) timer.it_value.tv_sec * 1000000 + timer.it_value.tv_usec;
+
+    // 醒来的原因可能是其它中断，但与此同时定时器也可能已到期，所以看节拍信号是否挂起
+    sigpending(&set);
+    if (sigismember(&set, TINYOS_PORT_SIG_TICK)) {
+        // 已经睡满，定时器已重装为一个节拍周期。最后一个节拍由挂起的节拍信号处理，下一个节拍照剩余时间继续
+        elapsed = ticks - 1;
+        nextUs = leftUs;
+    } else {
+        // 被其它中断提前唤醒，从上一个节拍边界算起经过的完整节拍，下一个节拍仍对齐到原来的节拍边界
+        since += sleepUs - leftUs;
+        elapsed = (uint32_t) (since / sysTickUs);
+        nextUs = sysTickUs - since % sysTickUs;
+    }
+
+    // it_value为0会停止定时器
+    timer.it_value = usToTimeval(nextUs ? nextUs : 1);
+    timer.it_interval = usToTimeval(sysTickUs);
+    setitimer(ITIMER_REAL, &timer, (struct itimerval *) 0);
+
+    return elapsed;
+}
@@ -0,0 +1,29 @@
+/**
+ * @brief tinyOS的POSIX主机移植层配置
+ * @details 在Linux等POSIX系统上，用一个进程模拟整块芯片：任务运行在ucontext上下文中，
+ *          时钟节拍与外部中断都用信号模拟，关中断即屏蔽这些信号。
+ * @author 01课堂 李述铜 http://01ketang.cc
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#ifndef TPORT_H
+#define TPORT_H
+
+#include <signal.h>
+
+#define TINYOS_PORT_SIG_TICK            SIGALRM                 // 模拟SysTick中断的信号
+#define TINYOS_PORT_SIG_IRQ(irq)        (SIGRTMIN + (irq))      // 模拟外部中断的信号，irq为hal.h中的IRQType
+#define TINYOS_PORT_IRQ_COUNT           3                       // 模拟的外部中断个数
+#define TINYOS_PORT_SIG_PENDSV          SIGUSR1                 // 模拟PendSV的信号，挂起多次只处理一次
+
+// 主机上printf、信号处理等都要在任务栈上运行，所需空间远大于Cortex-M。
+// 应用给出的堆栈小于该值时，移植层另外为任务分配运行栈
+#define TINYOS_PORT_STACK_MIN           (64 * 1024)
+
+// 无节拍空闲模式下单次休眠的最长节拍数
+#define TINYOS_PORT_SLEEP_MAX_TICKS     (60 * TICKS_PER_SEC)
+
+void tPortInterruptSet (sigset_t *set);
+
+#endif /* TPORT_H */
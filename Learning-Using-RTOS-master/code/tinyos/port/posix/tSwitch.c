@@ -0,0 +1,212 @@
+/**
+ * @brief tinyOS任务切换与CPU相关的函数，POSIX主机版本
+ * @author 01课堂 李述铜 http://01ketang.cc
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+
+/**
+ * @defgroup 内核核心 内核核心
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+#include "tinyOS.h"
+#include "tPort.h"
+
+// 与Cortex-M版本的对应关系：
+// 1、PRIMASK关中断，对应为屏蔽时钟节拍、外部中断及PendSV所用的信号；
+// 2、PendSV中保存/恢复R4-R11及PSP，对应为在PendSV信号的处理函数中用swapcontext保存/恢复整个ucontext。
+//    swapcontext会同时切换信号屏蔽字，所以每个任务都有自己的“中断开关”状态，与在PendSV中切换的效果一致；
+// 3、与Cortex-M一样，tTaskSwitch只是挂起PendSV信号。临界区及其它中断处理中都屏蔽了该信号，
+//    所以切换总是推迟到退出最外层临界区、且没有中断在处理时才进行。
+
+// 任务的运行现场。放在任务堆栈的顶部，task->stack始终指向它
+typedef struct _tTaskContext {
+    ucontext_t context;                 /**< 任务的CPU现场 */
+    void (*entry) (void *);             /**< 任务的入口函数 */
+    void *param;                        /**< 传递给入口函数的参数 */
+} tTaskContext;
+
+// 临界区要屏蔽的信号个数：时钟节拍、各外部中断及PendSV
+#define TINYOS_PORT_SIG_COUNT           (TINYOS_PORT_IRQ_COUNT + 2)
+
+/**
+ * 获取临界区状态值中某一位对应的信号
+ * @param index 状态值中的位序号
+ * @return 对应的信号
+ */
+static int interruptSignal (int index) {
+    if (index == 0) {
+        return TINYOS_PORT_SIG_TICK;
+    } else if (index <= TINYOS_PORT_IRQ_COUNT) {
+        return TINYOS_PORT_SIG_IRQ(index - 1);
+    } else {
+        return TINYOS_PORT_SIG_PENDSV;
+    }
+}
+
+/**
+ * 获取所有模拟中断所用的信号，包括时钟节拍及PendSV
+ * @param set 存储信号集合的位置
+ */
+void tPortInterruptSet (sigset_t *set) {
+    int index;
+
+    sigemptyset(set);
+    for (index = 0; index < TINYOS_PORT_SIG_COUNT; index++) {
+        sigaddset(set, interruptSignal(index));
+    }
+}
+
+/**
+ * 进入临界区
+ * @return 进入之前的临界区状态值：每一位对应一个在进入前处于打开状态的中断
+ */
+uint32_t tTaskEnterCritical (void) {
+    sigset_t set, old;
+    uint32_t status = 0;
+    int index;
+
+    tPortInterruptSet(&set);
+    sigprocmask(SIG_BLOCK, &set, &old);
+
+    for (index = 0; index < TINYOS_PORT_SIG_COUNT; index++) {
+        if (!sigismember(&old, interruptSignal(index))) {
+            status |= 1 << index;
+        }
+    }
+    return status;
+}
+
+/**
+ * 退出临界区,恢复之前的临界区状态
+ * @param status 进入临界区之前的临界区状态值
+ */
+void tTaskExitCritical (uint32_t status) {
+    sigset_t set;
+    int index;
+
+    // 嵌套在其它临界区或中断中时，进入前所有中断都是关闭的，不需要做任何事
+    if (status == 0) {
+        return;
+    }
+
+    sigemptyset(&set);
+    for (index = 0; index < TINYOS_PORT_SIG_COUNT; index++) {
+        if (status & (1 << index)) {
+            sigaddset(&set, interruptSignal(index));
+        }
+    }
+
+    // 解除屏蔽时，期间挂起的信号会立即被处理，与打开中断后立即响应挂起的中断相同
+    sigprocmask(SIG_UNBLOCK, &set, (sigset_t *) 0);
+}
+
+/**
+ * 所有任务共用的入口，从当前任务的现场中取出真正的入口函数及参数
+ */
+static void taskEntry (void) {
+    tTaskContext *context = (tTaskContext *) currentTask->stack;
+
+    context->entry(context->param);
+
+    // 任务不应通过return结束自己，在Cortex-M上这会返回到无效地址而产生异常
+    fprintf(stderr, "tinyOS: task %p returned from its entry\n", (void *) currentTask);
+    abort();
+}
+
+/**
+ * 为从未运行过的任务构造初始现场，使其能够像被切换出去的任务一样被恢复运行
+ * @param stack 任务堆栈的起始地址
+ * @param size 任务堆栈的字节数
+ * @param entry 任务的入口函数
+ * @param param 传递给任务的运行参数
+ * @return 任务现场的地址，即任务的stack值
+ */
+uint32_t *tTaskStackInit (uint32_t *stack, uint32_t size, void (*entry) (void *), void *param) {
+    uintptr_t top = (uintptr_t) stack + size;
+    tTaskContext *context;
+    void *runStack = stack;
+    size_t runSize;
+
+    // 现场放在堆栈顶部，按16字节对齐以满足ucontext_t中浮点现场的要求
+    if (size < sizeof(tTaskContext) + 16) {
+        fprintf(stderr, "tinyOS: task stack of %u bytes is too small for the host port\n", (unsigned) size);
+        abort();
+    }
+    context = (tTaskContext *) ((top - sizeof(tTaskContext)) & ~(uintptr_t) 15);
+    runSize = (uintptr_t) context - (uintptr_t) stack;
+
+    // 应用的堆栈按Cortex-M估算，通常放不下主机上的函数调用及信号处理现场，此时另外分配运行栈。
+    // 该运行栈在任务删除后不回收，主机上任务个数有限，可以接受
+    if (runSize < TINYOS_PORT_STACK_MIN) {
+        runSize = TINYOS_PORT_STACK_MIN;
+        runStack = malloc(runSize);
+        if (runStack == (void *) 0) {
+            fprintf(stderr, "tinyOS: no memory for a task stack\n");
+            abort();
+        }
+    }
+
+    context->entry = entry;
+    context->param = param;
+    getcontext(&context->context);
+    context->context.uc_stack.ss_sp = runStack;
+    context->context.uc_stack.ss_size = runSize;
+    context->context.uc_link = (ucontext_t *) 0;
+
+    // 任务开始运行时中断是打开的，与Cortex-M从PendSV返回到新任务时一致
+    sigemptyset(&context->context.uc_sigmask);
+    makecontext(&context->context, taskEntry, 0);
+
+    return (uint32_t *) context;
+}
+
+/**
+ * PendSV信号的处理函数，在这里完成真正的任务切换
+ */
+static void pendSVHandler (int sig) {
+    tTask *fromTask = currentTask;
+    (void) sig;
+
+    // 之后的某个时候，将会再次切换到该任务运行，此时从swapcontext返回，
+    // 随后从信号处理函数返回，恢复该任务被打断前的信号屏蔽字
+    currentTask = nextTask;
+    if (fromTask != currentTask) {
+        swapcontext(&((tTaskContext *) fromTask->stack)->context, &((tTaskContext *) currentTask->stack)->context);
+    }
+}
+
+/**
+ * 在启动tinyOS时，调用该函数，将切换至第一个任务运行
+ */
+void tTaskRunFirst () {
+    struct sigaction action;
+
+    // PendSV优先级最低，处理期间屏蔽其它所有中断，保证currentTask与现场一致
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = pendSVHandler;
+    tPortInterruptSet(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(TINYOS_PORT_SIG_PENDSV, &action, (struct sigaction *) 0);
+
+    currentTask = nextTask;
+
+    // 与Cortex-M版本一样，这个函数是没有返回的，main的现场直接丢弃
+    setcontext(&((tTaskContext *) currentTask->stack)->context);
+}
+
+/**
+ * 进行一次任务切换，tinyOS会预先配置好currentTask和nextTask, 然后调用该函数，切换至nextTask运行
+ */
+void tTaskSwitch () {
+    // 和Cortex-M一样触发PendSV，退出临界区后才会真正切换
+    raise(TINYOS_PORT_SIG_PENDSV);
+}
+
+/** @} */
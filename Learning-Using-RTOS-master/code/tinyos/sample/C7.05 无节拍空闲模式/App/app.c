@@ -0,0 +1,74 @@
+/**
+ * @brief tOS应用示例
+ * @details 无节拍空闲模式：所有任务都在等待时，空闲任务停止时钟节拍并让CPU休眠，
+ *          直到最近的任务或定时器到期才唤醒。可以看到tickCount照常增长，而节拍中断次数少得多
+ * @author 01课堂 李述铜 http://01ketang.cc
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#include "tinyOS.h"
+#include "app.h"
+#include "hal.h"
+
+static tTask task1;                     // 任务1结构
+static tTask task2;                     // 任务2结构
+
+static tTaskStack task1Env[TASK1_ENV_SIZE];     // 任务1的堆栈空间
+static tTaskStack task2Env[TASK2_ENV_SIZE];     // 任务2的堆栈空间
+
+static tSem sem;                        // 任务2等待的信号量，没有人释放，每次都会超时
+static tTimer timer;                    // 周期性的软定时器
+
+extern uint32_t sysTickCount;           // 实际发生的时钟节拍中断次数，在tHooks.c中统计
+
+int timerCount;                         // 定时器回调的次数
+int timeoutCount;                       // 任务2等待超时的次数
+
+/**
+ * 定时器回调函数
+ * @param arg 回调参数
+ */
+void timerFunc (void *arg) {
+    timerCount++;
+}
+
+/**
+ * 任务的运行代码：每秒输出一次统计结果
+ * @param param 任务初始运行参数
+ */
+void task1Entry (void *param) {
+    for (;;) {
+        tTaskDelay(TICKS_PER_SEC);
+
+        xprintf("tick: %d, tick irq: %d, timer: %d, timeout: %d\n",
+                tickCount, sysTickCount, timerCount, timeoutCount);
+    }
+}
+
+/**
+ * 任务的运行代码：带超时地等待信号量
+ * @param param 任务初始运行参数
+ */
+void task2Entry (void *param) {
+    for (;;) {
+        if (tSemWait(&sem, TICKS_PER_SEC / 4) == tErrorTimeout) {
+            timeoutCount++;
+        }
+    }
+}
+
+/**
+ * App的初始化
+ */
+void tInitApp (void) {
+    halInit();
+
+    tSemInit(&sem, 0, 0);
+
+    tTimerInit(&timer, 0, TICKS_PER_SEC / 2, timerFunc, (void *) 0, TIMER_CONFIG_TYPE_SOFT);
+    tTimerStart(&timer);
+
+    tTaskInit(&task1, task1Entry, (void *) 0x0, TASK1_PRIO, task1Env, sizeof(task1Env));
+    tTaskInit(&task2, task2Entry, (void *) 0x0, TASK2_PRIO, task2Env, sizeof(task2Env));
+}
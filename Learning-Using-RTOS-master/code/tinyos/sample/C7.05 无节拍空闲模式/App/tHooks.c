@@ -0,0 +1,31 @@
+/**
+ * @brief tinyOS 回调接口
+ * @author 01课堂 李述铜 http://01ketang.cc
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#include "tHooks.h"
+#include "tinyOS.h"
+
+#if TINYOS_ENABLE_HOOKS == 1
+
+uint32_t sysTickCount = 0;          // 实际发生的时钟节拍中断次数
+
+void tHooksCpuIdle (void) {
+
+}
+
+void tHooksSysTick (void) {
+    sysTickCount++;
+}
+
+void tHooksTaskSwitch (tTask *from, tTask *to) {
+
+}
+
+void tHooksTaskInit (tTask *task) {
+
+}
+
+#endif
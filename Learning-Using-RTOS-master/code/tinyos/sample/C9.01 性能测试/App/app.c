@@ -0,0 +1,306 @@
+/**
+ * @brief tOS性能测试
+ * @details 参照Thread-Metric的测试项目，测量任务切换、中断处理及各个内核对象的开销。
+ *          每项测试运行BENCH_REPORT_COUNT个统计周期，每个周期报告完成的操作次数，
+ *          以及按周期计数器折算的每次操作的平均周期数。修改内核后，用同一配置对比前后的结果即可。
+ * @author 01课堂 李述铜 http://01ketang.cc
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#include "tinyOS.h"
+#include "app.h"
+#include "hal.h"
+
+static tTask benchReportTask;                                       // 报告任务结构
+static tTaskStack benchReportEnv[BENCH_REPORT_ENV_SIZE];            // 报告任务的堆栈空间
+
+static tTask benchTask[BENCH_TASK_COUNT];                           // 测试任务结构
+static tTaskStack benchTaskEnv[BENCH_TASK_COUNT][BENCH_ENV_SIZE];   // 测试任务的堆栈空间
+static uint32_t benchTaskUsed;                                      // 当前测试用到的任务数量
+
+static tSem benchSemA;                                              // 测试用信号量
+static tSem benchSemB;                                              // 测试用信号量
+static tMbox benchMbox;                                             // 测试用邮箱
+static void *benchMboxBuffer[BENCH_MBOX_SIZE];                      // 邮箱的消息缓冲区
+static tMutex benchMutex;                                           // 测试用互斥信号量
+static tMemBlock benchMemBlock;                                     // 测试用存储块
+static uint8_t benchMem[BENCH_MEMBLOCK_COUNT][BENCH_MEMBLOCK_SIZE];  // 存储块的存储区
+
+static volatile uint32_t benchCount;                                // 已完成的操作次数
+
+/**
+ * 创建一个测试任务
+ * @param entry 任务的入口函数
+ * @param param 传递给任务的参数
+ * @param prio 任务的优先级
+ */
+static void benchTaskCreate (void (*entry) (void *), void *param, uint32_t prio) {
+    tTaskInit(&benchTask[benchTaskUsed], entry, param, prio, benchTaskEnv[benchTaskUsed], sizeof(benchTaskEnv[0]));
+    benchTaskUsed++;
+}
+
+/**
+ * 主动放弃CPU，切换到同优先级的下一个任务。tinyOS没有提供该接口，这里将自己移到就绪队列尾部后调度
+ */
+static void benchYield (void) {
+    uint32_t status = tTaskEnterCritical();
+
+    tTaskSchedUnRdy(currentTask);
+    tTaskSchedRdy(currentTask);
+    tTaskSched();
+
+    tTaskExitCritical(status);
+}
+
+/**
+ * 中断处理函数：释放信号量，由中断测试中的任务获取
+ */
+void IRQHighHandler (void) {
+    tSemNotify(&benchSemA);
+}
+
+/**
+ * 协作式切换：同优先级的任务轮流主动放弃CPU
+ */
+static void cooperativeEntry (void *param) {
+    for (;;) {
+        benchCount++;
+        benchYield();
+    }
+}
+
+static void cooperativeInit (void) {
+    int i;
+
+    for (i = 0; i < BENCH_TASK_COUNT; i++) {
+        benchTaskCreate(cooperativeEntry, (void *) 0, BENCH_TASK_PRIO);
+    }
+}
+
+/**
+ * 抢占式切换：每个任务唤醒比自己高一级的任务而被其抢占，最高优先级的任务再挂起自己
+ */
+static void preemptiveEntry (void *param) {
+    uint32_t index = (uint32_t) (uintptr_t) param;
+
+    for (;;) {
+        if (index > 0) {
+            tTaskWakeUp(&benchTask[index - 1]);
+        }
+
+        benchCount++;
+
+        // 优先级最低的任务不挂起，由它开始下一轮
+        if (index < BENCH_TASK_COUNT - 1) {
+            tTaskSuspend(currentTask);
+        }
+    }
+}
+
+static void preemptiveInit (void) {
+    int i;
+
+    for (i = 0; i < BENCH_TASK_COUNT; i++) {
+        benchTaskCreate(preemptiveEntry, (void *) (uintptr_t) i, BENCH_TASK_PRIO + i);
+    }
+}
+
+/**
+ * 不引起抢占的中断处理：任务触发中断，中断释放信号量，任务再取走
+ */
+static void irqEntry (void *param) {
+    for (;;) {
+        interruptByIRQ(IRQ_PRIO_HIGH);
+        tSemWait(&benchSemA, 0);
+        benchCount++;
+    }
+}
+
+static void irqInit (void) {
+    benchTaskCreate(irqEntry, (void *) 0, BENCH_TASK_PRIO);
+}
+
+/**
+ * 引起抢占的中断处理：中断释放的信号量由高优先级任务等待，中断返回时切换到该任务
+ */
+static void irqPreemptHighEntry (void *param) {
+    for (;;) {
+        tSemWait(&benchSemA, 0);
+        benchCount++;
+    }
+}
+
+static void irqPreemptLowEntry (void *param) {
+    for (;;) {
+        interruptByIRQ(IRQ_PRIO_HIGH);
+    }
+}
+
+static void irqPreemptInit (void) {
+    benchTaskCreate(irqPreemptHighEntry, (void *) 0, BENCH_TASK_PRIO);
+    benchTaskCreate(irqPreemptLowEntry, (void *) 0, BENCH_TASK_PRIO + 1);
+}
+
+/**
+ * 消息传递：向邮箱发送一个消息，再立即取回
+ */
+static void mboxEntry (void *param) {
+    void *msg = (void *) benchMem;
+
+    for (;;) {
+        tMboxNotify(&benchMbox, msg, tMBOXSendNormal);
+        tMboxWait(&benchMbox, &msg, 0);
+        benchCount++;
+    }
+}
+
+static void mboxInit (void) {
+    benchTaskCreate(mboxEntry, (void *) 0, BENCH_TASK_PRIO);
+}
+
+/**
+ * 信号量乒乓：两个任务通过一对信号量交替运行，每个来回计一次
+ */
+static void semPingEntry (void *param) {
+    for (;;) {
+        tSemNotify(&benchSemB);
+        tSemWait(&benchSemA, 0);
+        benchCount++;
+    }
+}
+
+static void semPongEntry (void *param) {
+    for (;;) {
+        tSemWait(&benchSemB, 0);
+        tSemNotify(&benchSemA);
+    }
+}
+
+static void semInit (void) {
+    benchTaskCreate(semPingEntry, (void *) 0, BENCH_TASK_PRIO);
+    benchTaskCreate(semPongEntry, (void *) 0, BENCH_TASK_PRIO);
+}
+
+/**
+ * 互斥信号量：无竞争时的加锁与解锁
+ */
+static void mutexEntry (void *param) {
+    for (;;) {
+        tMutexWait(&benchMutex, 0);
+        tMutexNotify(&benchMutex);
+        benchCount++;
+    }
+}
+
+static void mutexInit (void) {
+    benchTaskCreate(mutexEntry, (void *) 0, BENCH_TASK_PRIO);
+}
+
+/**
+ * 存储块：申请一块后立即释放
+ */
+static void memBlockEntry (void *param) {
+    void *mem;
+
+    for (;;) {
+        tMemBlockWait(&benchMemBlock, &mem, 0);
+        tMemBlockNotify(&benchMemBlock, mem);
+        benchCount++;
+    }
+}
+
+static void memBlockInit (void) {
+    benchTaskCreate(memBlockEntry, (void *) 0, BENCH_TASK_PRIO);
+}
+
+// 测试项目
+static const struct {
+    const char *name;                   /**< 测试名称 */
+    void (*init) (void);                /**< 创建测试所需的任务 */
+} benchList[] = {
+        {"cooperative context switch", cooperativeInit},
+        {"preemptive context switch",  preemptiveInit},
+        {"interrupt processing",       irqInit},
+        {"interrupt preemption",       irqPreemptInit},
+        {"message processing (tMbox)", mboxInit},
+        {"semaphore ping-pong (tSem)", semInit},
+        {"mutex lock/unlock (tMutex)", mutexInit},
+        {"memory alloc/free (tMemBlock)", memBlockInit},
+};
+
+/**
+ * 初始化各项测试共用的内核对象
+ */
+static void benchObjectInit (void) {
+    tSemInit(&benchSemA, 0, 0);
+    tSemInit(&benchSemB, 0, 0);
+    tMboxInit(&benchMbox, benchMboxBuffer, BENCH_MBOX_SIZE);
+    tMutexInit(&benchMutex);
+    tMemBlockInit(&benchMemBlock, benchMem, BENCH_MEMBLOCK_SIZE, BENCH_MEMBLOCK_COUNT);
+}
+
+/**
+ * 结束当前测试：先删除内核对象，使等待其中的任务回到就绪状态，再删除所有测试任务
+ * 报告任务的优先级最高，这期间不会切换到测试任务
+ */
+static void benchCleanup (void) {
+    uint32_t i;
+
+    tSemDestroy(&benchSemA);
+    tSemDestroy(&benchSemB);
+    tMboxDestroy(&benchMbox);
+    tMutexDestroy(&benchMutex);
+    tMemBlockDestroy(&benchMemBlock);
+
+    for (i = 0; i < benchTaskUsed; i++) {
+        tTaskForceDelete(&benchTask[i]);
+    }
+    benchTaskUsed = 0;
+}
+
+/**
+ * 报告任务：依次运行各项测试并输出结果
+ * @param param 任务初始运行参数
+ */
+void benchReportEntry (void *param) {
+    uint32_t i, report;
+
+    xprintf("tinyOS benchmark: %d ticks per interval, %d ms per tick\n", BENCH_INTERVAL_TICKS, TINYOS_SYSTICK_MS);
+
+    for (i = 0; i < sizeof(benchList) / sizeof(benchList[0]); i++) {
+        xprintf("%s\n", benchList[i].name);
+
+        benchObjectInit();
+        benchList[i].init();
+
+        for (report = 0; report < BENCH_REPORT_COUNT; report++) {
+            uint32_t startCount = benchCount;
+            uint32_t startCycle = targetCycleGet();
+            uint32_t count, cycle;
+
+            tTaskDelay(BENCH_INTERVAL_TICKS);
+
+            cycle = targetCycleGet() - startCycle;
+            count = benchCount - startCount;
+            xprintf("    %lu ops, %lu cycles/op\n", (unsigned long) count, (unsigned long) (count ? cycle / count : 0));
+        }
+
+        benchCleanup();
+    }
+
+    xprintf("tinyOS benchmark: done\n");
+    tTaskDeleteSelf();
+}
+
+/**
+ * App的初始化
+ */
+void tInitApp (void) {
+    halInit();
+    targetCycleInit();
+
+    interruptEnable(IRQ_PRIO_HIGH, 1);
+
+    tTaskInit(&benchReportTask, benchReportEntry, (void *) 0, BENCH_REPORT_PRIO, benchReportEnv, sizeof(benchReportEnv));
+}
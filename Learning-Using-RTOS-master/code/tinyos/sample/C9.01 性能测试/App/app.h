@@ -0,0 +1,34 @@
+/**
+ * @brief tOS应用示例
+ * @details
+ * @author 01课堂 lishutong
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#ifndef PROJECT_APP_H_H
+#define PROJECT_APP_H_H
+
+#include <stdio.h>
+#include "tinyOS.h"
+#include "hal.h"
+
+#define BENCH_TASK_COUNT            5               // 参与测试的任务数量
+#define BENCH_ENV_SIZE              512             // 测试任务的堆栈空间单元数
+#define BENCH_REPORT_ENV_SIZE       512             // 报告任务的堆栈空间单元数
+
+#define BENCH_REPORT_PRIO           0               // 报告任务的优先级，必须最高
+#define BENCH_TASK_PRIO             2               // 测试任务的最高优先级，依次往下使用BENCH_TASK_COUNT个优先级
+
+// 每次统计的时长。周期计数器只有32位，该时长要小于其回绕周期：
+// 72MHz的DWT约为59秒，4GHz的TSC约为1秒
+#define BENCH_INTERVAL_TICKS        (TICKS_PER_SEC / 2)
+#define BENCH_REPORT_COUNT          4               // 每项测试统计的次数
+
+#define BENCH_MBOX_SIZE             4               // 消息测试所用邮箱的大小
+#define BENCH_MEMBLOCK_SIZE         16              // 存储块测试中每块的字节数
+#define BENCH_MEMBLOCK_COUNT        4               // 存储块测试中块的数量
+
+void benchReportEntry (void *param);
+
+#endif //PROJECT_APP_H_H
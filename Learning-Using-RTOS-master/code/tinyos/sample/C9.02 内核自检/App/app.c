@@ -0,0 +1,237 @@
+/**
+ * @brief tOS内核自检
+ * @details 检查延时队列、分层时间轮与无节拍空闲模式的行为：任务和定时器都应在启动后正好第N个节拍到期，
+ *          无节拍空闲时tickCount照常补齐，而实际的节拍中断少得多。每项检查输出ok或FAILED，最后汇总失败的项数。
+ *          修改这几部分内核代码后，运行本示例确认结果全部为ok
+ * @author 01课堂 李述铜 http://01ketang.cc
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#include "tinyOS.h"
+#include "app.h"
+#include "hal.h"
+
+static tTask checkTask;                                             // 自检任务结构
+static tTaskStack checkEnv[CHECK_ENV_SIZE];                         // 自检任务的堆栈空间
+
+static tTask delayTask[DELAY_TASK_COUNT];                           // 延时测试任务结构
+static tTaskStack delayTaskEnv[DELAY_TASK_COUNT][DELAY_ENV_SIZE];   // 延时测试任务的堆栈空间
+
+// 各延时测试任务的延时节拍数，唤醒顺序应按到期时刻而不是加入延时队列的先后
+static const uint32_t delayTicks[DELAY_TASK_COUNT] = {30, 10, 25, 15};
+static uint32_t delayElapsed[DELAY_TASK_COUNT];                     // 各任务实际延时的节拍数
+static uint32_t delayOrder[DELAY_TASK_COUNT];                       // 任务被唤醒的顺序
+static uint32_t delayWoken;                                         // 已唤醒的任务数量
+
+static tSem waitSem;                                                // 带超时等待、在超时前被释放的信号量
+static tError waitResult;                                           // 等待的结果
+static uint32_t waitElapsed;                                        // 等待的节拍数
+
+// 一次性硬定时器的定时，覆盖时间轮各层槽的边界及超出最高层范围的情况
+static const uint32_t wheelTicks[WHEEL_TIMER_COUNT] = {1, 15, 16, 17, 255, 256, 257, 300, 4095, 4096, 4100};
+static const uint32_t softTicks[SOFT_TIMER_COUNT] = {5, 16, 300};
+static tTimer wheelTimer[WHEEL_TIMER_COUNT];                        // 一次性硬定时器
+static tTimer softTimer[SOFT_TIMER_COUNT];                          // 一次性软定时器
+static tTimer periodTimer;                                          // 周期性硬定时器
+static tTimer stopTimer;                                            // 到期前被停止的硬定时器
+static uint32_t wheelStart, softStart;                              // 启动定时器时的tickCount
+static uint32_t wheelElapsed[WHEEL_TIMER_COUNT];                    // 各定时器实际到期的节拍数，0表示未到期
+static uint32_t softElapsed[SOFT_TIMER_COUNT];
+static uint32_t periodCount;                                        // 周期性定时器到期的次数
+static uint32_t stopCount;                                          // 被停止的定时器到期的次数
+
+extern uint32_t sysTickCount;                                       // 实际发生的时钟节拍中断次数，在tHooks.c中统计
+
+static int failCount;                                               // 未通过的检查项数
+
+/**
+ * 输出一项检查的结果
+ * @param name 检查项的名称
+ * @param ok 是否通过
+ */
+static void check (const char *name, int ok) {
+    xprintf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+    if (!ok) {
+        failCount++;
+    }
+}
+
+/**
+ * 延时测试任务：延时后记下实际经过的节拍数及唤醒顺序
+ */
+static void delayEntry (void *param) {
+    uint32_t index = (uint32_t) (uintptr_t) param;
+    uint32_t start;
+
+    // 在临界区内读取tickCount并进入延时，中间不会插入节拍
+    uint32_t status = tTaskEnterCritical();
+    start = tickCount;
+    tTaskDelay(delayTicks[index]);
+    tTaskExitCritical(status);
+
+    delayElapsed[index] = tickCount - start;
+    delayOrder[delayWoken++] = index;
+    tTaskDeleteSelf();
+}
+
+/**
+ * 带超时的等待：在超时前被释放，任务应从延时队列中移除，不影响其它延时的任务
+ */
+static void waitEntry (void *param) {
+    uint32_t start;
+
+    uint32_t status = tTaskEnterCritical();
+    start = tickCount;
+    tTaskExitCritical(status);
+
+    waitResult = tSemWait(&waitSem, 50);
+    waitElapsed = tickCount - start;
+    tTaskDeleteSelf();
+}
+
+/**
+ * 检查延时队列：任务按到期时刻唤醒，且正好延时所要求的节拍数
+ */
+static void checkDelayQueue (void) {
+    static const uint32_t order[DELAY_TASK_COUNT] = {1, 3, 2, 0};
+    static tTask waitTask;
+    static tTaskStack waitTaskEnv[DELAY_ENV_SIZE];
+    uint32_t i;
+    int ok = 1;
+
+    tSemInit(&waitSem, 0, 0);
+    for (i = 0; i < DELAY_TASK_COUNT; i++) {
+        tTaskInit(&delayTask[i], delayEntry, (void *) (uintptr_t) i, DELAY_PRIO + i, delayTaskEnv[i], sizeof(delayTaskEnv[i]));
+    }
+    tTaskInit(&waitTask, waitEntry, (void *) 0, DELAY_PRIO + DELAY_TASK_COUNT, waitTaskEnv, sizeof(waitTaskEnv));
+
+    // 让测试任务都进入延时，5个节拍后释放信号量
+    tTaskDelay(5);
+    tSemNotify(&waitSem);
+    tTaskDelay(40);
+
+    for (i = 0; i < DELAY_TASK_COUNT; i++) {
+        ok = ok && (delayElapsed[i] == delayTicks[i]) && (delayOrder[i] == order[i]);
+    }
+    check("delay queue: wake ticks", ok && (delayWoken == DELAY_TASK_COUNT));
+    check("delay queue: early removal", (waitResult == tErrorNoError) && (waitElapsed == 5));
+
+    tSemDestroy(&waitSem);
+}
+
+/**
+ * 定时器回调：记下到期时经过的节拍数
+ */
+static void wheelFunc (void *arg) {
+    uint32_t index = (uint32_t) (uintptr_t) arg;
+    wheelElapsed[index] = tickCount - wheelStart;
+}
+
+static void softFunc (void *arg) {
+    uint32_t index = (uint32_t) (uintptr_t) arg;
+    softElapsed[index] = tickCount - softStart;
+}
+
+static void periodFunc (void *arg) {
+    periodCount++;
+}
+
+static void stopFunc (void *arg) {
+    stopCount++;
+}
+
+/**
+ * 检查时间轮：定时器在各层之间重新分配后仍然正好在启动后第N个节拍到期。
+ * 等待期间除了定时器到期没有别的事要做，空闲任务一直以无节拍模式休眠，同时检查跳过的节拍是否补齐
+ */
+static void checkTimerWheel (void) {
+    uint32_t i, status, irqStart, tickStart;
+    int ok = 1;
+
+    for (i = 0; i < WHEEL_TIMER_COUNT; i++) {
+        tTimerInit(&wheelTimer[i], wheelTicks[i], 0, wheelFunc, (void *) (uintptr_t) i, TIMER_CONFIG_TYPE_HARD);
+    }
+    for (i = 0; i < SOFT_TIMER_COUNT; i++) {
+        tTimerInit(&softTimer[i], softTicks[i], 0, softFunc, (void *) (uintptr_t) i, TIMER_CONFIG_TYPE_SOFT);
+    }
+    tTimerInit(&periodTimer, 0, 7, periodFunc, (void *) 0, TIMER_CONFIG_TYPE_HARD);
+    tTimerInit(&stopTimer, 150, 0, stopFunc, (void *) 0, TIMER_CONFIG_TYPE_HARD);
+
+    // 硬定时器在同一个节拍内全部启动
+    status = tTaskEnterCritical();
+    wheelStart = tickCount;
+    for (i = 0; i < WHEEL_TIMER_COUNT; i++) {
+        tTimerStart(&wheelTimer[i]);
+    }
+    tTimerStart(&periodTimer);
+    tTimerStart(&stopTimer);
+    tTaskExitCritical(status);
+
+    // 软定时器的启动要获取信号量，不能在临界区内进行。自检任务的优先级低于定时器任务，软定时器时间轮已跟上tickCount
+    softStart = tickCount;
+    for (i = 0; i < SOFT_TIMER_COUNT; i++) {
+        tTimerStart(&softTimer[i]);
+    }
+
+    // 周期性定时器在第7, 14, ..., 98个节拍到期，共14次
+    tTaskDelay(100);
+    tTimerStop(&periodTimer);
+    tTimerStop(&stopTimer);
+    check("timer wheel: periodic", periodCount == 14);
+
+    status = tTaskEnterCritical();
+    irqStart = sysTickCount;
+    tickStart = tickCount;
+    tTaskExitCritical(status);
+
+    tTaskDelay(WHEEL_WAIT_TICKS - 100);
+
+    for (i = 0; i < WHEEL_TIMER_COUNT; i++) {
+        ok = ok && (wheelElapsed[i] == wheelTicks[i]);
+    }
+    check("timer wheel: hard timers", ok);
+
+    ok = 1;
+    for (i = 0; i < SOFT_TIMER_COUNT; i++) {
+        ok = ok && (softElapsed[i] == softTicks[i]);
+    }
+    check("timer wheel: soft timers", ok);
+    check("timer wheel: stopped timer", stopCount == 0);
+
+    // 这段时间里只有少数几个时刻有定时器到期，绝大部分节拍都应被跳过
+    check("tickless: ticks accounted", tickCount - tickStart == WHEEL_WAIT_TICKS - 100);
+    check("tickless: tick irqs skipped", (sysTickCount - irqStart) * 10 < WHEEL_WAIT_TICKS - 100);
+
+    for (i = 0; i < WHEEL_TIMER_COUNT; i++) {
+        tTimerDestroy(&wheelTimer[i]);
+    }
+    for (i = 0; i < SOFT_TIMER_COUNT; i++) {
+        tTimerDestroy(&softTimer[i]);
+    }
+    tTimerDestroy(&periodTimer);
+    tTimerDestroy(&stopTimer);
+}
+
+/**
+ * 自检任务：依次运行各项检查并汇总结果
+ * @param param 任务初始运行参数
+ */
+void checkEntry (void *param) {
+    xprintf("tinyOS self-check: %d ms per tick\n", TINYOS_SYSTICK_MS);
+
+    checkDelayQueue();
+    checkTimerWheel();
+
+    xprintf("tinyOS self-check: %d failed\n", failCount);
+    tTaskDeleteSelf();
+}
+
+/**
+ * App的初始化
+ */
+void tInitApp (void) {
+    halInit();
+
+    tTaskInit(&checkTask, checkEntry, (void *) 0, CHECK_PRIO, checkEnv, sizeof(checkEnv));
+}
@@ -0,0 +1,29 @@
+/**
+ * @brief tOS应用示例
+ * @details
+ * @author 01课堂 lishutong
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#ifndef PROJECT_APP_H_H
+#define PROJECT_APP_H_H
+
+#include <stdio.h>
+#include "tinyOS.h"
+#include "hal.h"
+
+#define CHECK_ENV_SIZE              512             // 自检任务的堆栈空间单元数
+#define CHECK_PRIO                  2               // 自检任务的优先级，低于定时器任务，软定时器时间轮不会落后于tickCount
+
+#define DELAY_TASK_COUNT            4               // 延时队列测试的任务数量
+#define DELAY_ENV_SIZE              512             // 延时测试任务的堆栈空间单元数
+#define DELAY_PRIO                  3               // 延时测试任务的最高优先级，依次往下使用DELAY_TASK_COUNT个优先级
+
+#define WHEEL_TIMER_COUNT           11              // 时间轮测试中一次性硬定时器的数量
+#define SOFT_TIMER_COUNT            3               // 时间轮测试中一次性软定时器的数量
+#define WHEEL_WAIT_TICKS            4200            // 时间轮测试等待的节拍数，要超过最长的定时
+
+void checkEntry (void *param);
+
+#endif //PROJECT_APP_H_H
@@ -0,0 +1,31 @@
+/**
+ * @brief tinyOS全局配置
+ * @author 01课堂 lishutong
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#ifndef TCONFIG_H
+#define TCONFIG_H
+
+#define TINYOS_PRO_COUNT                32                        // TinyOS任务的优先级序号
+#define TINYOS_SLICE_MAX                10                        // 每个任务最大运行的时间片计数
+
+#define TINYOS_IDLETASK_STACK_SIZE        1024                    // 空闲任务的堆栈单元数
+#define TINYOS_TIMERTASK_STACK_SIZE        1024                    // 定时器任务的堆栈单元数
+#define TINYOS_TIMERTASK_PRIO           1                       // 定时器任务的优先级
+
+#define TINYOS_SYSTICK_MS               1                       // 时钟节拍的周期，以ms为单位
+
+// 内核功能裁剪部分
+#define TINYOS_ENABLE_SEM               1                       // 是否使能信号量
+#define TINYOS_ENABLE_MUTEX             1                       // 是否使能互斥信号量
+#define TINYOS_ENABLE_FLAGGROUP         1                       // 是否使能事件标志组
+#define TINYOS_ENABLE_MBOX              1                       // 是否使能邮箱
+#define TINYOS_ENABLE_MEMBLOCK          1                       // 是否使能存储块
+#define TINYOS_ENABLE_TIMER             1                       // 是否使能定时器
+#define TINYOS_ENABLE_CPUUSAGE_STAT     0                       // 是否使能CPU使用率统计
+#define TINYOS_ENABLE_HOOKS             1                       // 是否使能Hooks
+#define TINYOS_ENABLE_TICKLESS          1                       // 是否使能无节拍空闲模式，需要tCpu.c实现tSysTickSleep
+
+#endif /* TCONFIG_H */
@@ -0,0 +1,92 @@
+/**
+ * @brief tinyOS 与处理器相关配置
+ * @author 01课堂 李述铜 http://01ketang.cc
+ * @date 2017-06-01
+ * @version 1.0
+ * @copyright 版权所有，禁止用于商业用途
+ */
+#include "tinyOS.h"
+#include "stm32f10x.h"
+
+/**
+ * 系统时钟节拍定时器System Tick配置
+ * 在我们目前的环境（模拟器）中，系统时钟节拍为12MHz
+ * 请务必按照本教程推荐配置，否则systemTick的值就会有变化，需要查看数据手册才了解
+ */
+void tSetSysTickPeriod (uint32_t ms) {
+    SystemCoreClockUpdate();
+    SysTick->LOAD = (uint64_t)ms * SystemCoreClock / 1000 - 1;
+    NVIC_SetPriority(SysTick_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk |
+                    SysTick_CTRL_TICKINT_Msk |
+                    SysTick_CTRL_ENABLE_Msk;
+}
+
+/**
+ * 无节拍空闲模式下的休眠：将SysTick重新设置为ticks个节拍后到期，用WFI休眠，醒来后恢复为周期性节拍
+ * 调用时中断已关闭，WFI在有中断挂起时即返回，中断处理函数在调用者退出临界区后才执行
+ * @param ticks 最长休眠的节拍数
+ * @return 休眠期间经过的完整节拍数。如果睡到了最后，SysTick中断已挂起，最后一个节拍由它处理，不计入返回值
+ */
+uint32_t tSysTickSleep (uint32_t ticks) {
+    uint32_t tickLoad = SysTick->LOAD + 1;              // 每个节拍的时钟数
+    uint32_t sleepLoad, since, passed, next, elapsed, ctrl;
+
+    // SysTick只有24位，限制最长的休眠时长
+    if (ticks > SysTick_LOAD_RELOAD_Msk / tickLoad) {
+        ticks = SysTick_LOAD_RELOAD_Msk / tickLoad;
+    }
+    if (ticks < 2) {
+        return 0;
+    }
+
+    // 停止计数，当前节拍中剩余的时间也计入休眠时长，到期时刻正好落在第ticks个节拍边界上
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    since = tickLoad - SysTick->VAL;                    // 从上一个节拍边界到现在的时钟数
+    sleepLoad = SysTick->VAL + tickLoad * (ticks - 1);
+    SysTick->LOAD = sleepLoad - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+
+    // 读CTRL会清除COUNTFLAG，所以只读一次
+    ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+
+    if (ctrl & SysTick_CTRL_COUNTFLAG_Msk) {
+        // 已经睡满，计数器重装后又走了一段，下一个节拍从到期时刻算起
+        passed = (sleepLoad - 1) - SysTick->VAL;
+        next = (passed < tickLoad) ? tickLoad - passed : tickLoad;
+        elapsed = ticks - 1;
+    } else {
+        // 被其它中断提前唤醒，从上一个节拍边界算起经过的完整节拍，下一个节拍仍对齐到原来的节拍边界
+        passed = (sleepLoad - 1) - SysTick->VAL;
+        since += passed;
+        next = tickLoad - since % tickLoad;
+        elapsed = since / tickLoad;
+    }
+
+    // LOAD为0时SysTick不会工作
+    if (next < 2) {
+        next = 2;
+    }
+
+    // 先按剩余时间装入，启动后立即改回正常周期，到期重装时生效
+    SysTick->LOAD = next - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = tickLoad - 1;
+
+    return elapsed;
+}
+
+/**
+ * SystemTick的中断处理函数
+ */
+void SysTick_Handler () {
+    tTaskSystemTickHandler();
+}
+
@@ -35,5 +35,6 @@
 #define TINYOS_ENABLE_TIMER             1                       // 是否使能定时器
 #define TINYOS_ENABLE_CPUUSAGE_STAT     0                       // 是否使能CPU使用率统计
 #define TINYOS_ENABLE_HOOKS             1                       // 是否使能Hooks
+#define TINYOS_ENABLE_TICKLESS          0                       // 是否使能无节拍空闲模式，需要tCpu.c实现tSysTickSleep
 
 #endif /* TCONFIG_H */
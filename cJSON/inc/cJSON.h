@@ -19,6 +19,9 @@
 #ifndef cJSON__h
 #define cJSON__h
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -35,6 +38,33 @@ extern "C"
 	
 #define cJSON_IsReference 256
 #define cJSON_StringIsConst 512
+/* Packed arrays: a cJSON_Array whose numbers sit in one contiguous buffer (valuestring) instead of child nodes. valueint holds the count. */
+#define cJSON_PackedInt32 1024
+#define cJSON_PackedInt64 2048
+#define cJSON_PackedDouble 4096
+#define cJSON_IsPacked (cJSON_PackedInt32|cJSON_PackedInt64|cJSON_PackedDouble)
+#define cJSON_ValueIsConst 8192		/* valuestring is borrowed, see cJSON_CreateStringCS */
+#define cJSON_NumberIsText 16384	/* cJSON_NO_FLOAT builds: a number with a fraction or exponent, kept as its text in valuestring */
+/* Opt-in: with cJSON_INLINE_SIZE defined above 0, short strings are kept in the node itself: string and valuestring then
+   point into text, and no allocation is made for them. The key and a string value share the buffer. Change a string with
+   cJSON_SetValuestring/cJSON_AddItemToObject rather than freeing it yourself. cJSON_INLINE_SIZE changes the size of cJSON,
+   so define it the same for everything that includes this. Left at 0, the node and the API are as they always were. */
+#define cJSON_StringIsInline 32768	/* string points into text */
+#define cJSON_ValueIsInline 65536	/* valuestring points into text */
+#define cJSON_StringIsBinary 131072	/* a cJSON_String holding raw bytes, valueint of them, in valuestring; see cJSON_CreateBinary */
+#ifndef cJSON_INLINE_SIZE
+#define cJSON_INLINE_SIZE 0
+#endif
+
+/* Numbers. Build with cJSON_NO_FLOAT defined for targets without an FPU: numbers are then held as int64_t and parsed and
+   printed with integer code only, so neither soft-float arithmetic nor libm gets linked in. Integers of any size round-trip
+   exactly. A number with a fraction or an exponent keeps its text and prints back unchanged, while valuedouble holds its
+   integer part. The float and double array builders and the cJSON_FieldDouble/cJSON_FieldFloat struct fields are left out. */
+#ifdef cJSON_NO_FLOAT
+typedef int64_t cJSON_number;
+#else
+typedef double cJSON_number;
+#endif
 
 /* The cJSON structure: */
 typedef struct cJSON {
@@ -45,9 +75,12 @@ typedef struct cJSON {
 
 	char *valuestring;			/* The item's string, if type==cJSON_String */
 	int valueint;				/* The item's number, if type==cJSON_Number */
-	double valuedouble;			/* The item's number, if type==cJSON_Number */
+	cJSON_number valuedouble;	/* The item's number, if type==cJSON_Number */
 
 	char *string;				/* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
+#if cJSON_INLINE_SIZE > 0
+	char text[cJSON_INLINE_SIZE];	/* Storage for short strings, see cJSON_StringIsInline. */
+#endif
 } cJSON;
 
 typedef struct cJSON_Hooks {
@@ -58,6 +91,53 @@ typedef struct cJSON_Hooks {
 /* Supply malloc, realloc and free functions to cJSON */
 extern void cJSON_InitHooks(cJSON_Hooks* hooks);
 
+/* A parse/print context: its own allocator, options and error position. The plain calls below share one global context;
+   give each thread (or task) its own cJSON_Context and use the WithContext calls to parse and print without a lock. */
+typedef struct cJSON_Context {
+	void *(*malloc_fn)(void *userdata,size_t sz);
+	void (*free_fn)(void *userdata,void *ptr);
+	void *userdata;					/* Handed back to malloc_fn/free_fn. */
+	int flags;						/* cJSON_Ctx* options. */
+	const char *errorptr;			/* Where the last failed parse on this context stopped, 0 after a successful one. */
+} cJSON_Context;
+
+/* Context flags */
+#define cJSON_CtxRequireNullTerminated 1	/* cJSON_ParseWithContext fails on anything but whitespace after the value. */
+#define cJSON_CtxSortKeys 2					/* cJSON_PrintWithContext prints object members sorted by key. */
+#define cJSON_CtxPackNumbers 4				/* cJSON_ParseWithContext stores arrays of plain numbers as packed arrays. */
+#define cJSON_CtxPrintAscii 8				/* cJSON_PrintWithContext escapes everything outside ASCII as \uXXXX. */
+
+/* Set ctx up with malloc/free, no flags and no error. Override the members you need afterwards. */
+extern void cJSON_InitContext(cJSON_Context *ctx);
+/* The context versions of the calls below. Everything they allocate comes from ctx. Nodes remember the context they came
+   from and go back to it when deleted, whichever delete call is used, so the item builders and editing calls without a
+   context (cJSON_Create*, cJSON_AddItemToObject, cJSON_DeleteItemFromObject, ...) work on any tree. Release printed
+   text with ctx->free_fn. ctx must outlive every node allocated through it. */
+extern cJSON *cJSON_ParseWithContext(cJSON_Context *ctx,const char *value,const char **return_parse_end);
+extern cJSON *cJSON_ParseWithLengthWithContext(cJSON_Context *ctx,const char *value,size_t length,const char **return_parse_end);
+extern char  *cJSON_PrintWithContext(cJSON_Context *ctx,cJSON *item,int fmt);
+extern void   cJSON_DeleteWithContext(cJSON_Context *ctx,cJSON *c);
+extern cJSON *cJSON_DuplicateWithContext(cJSON_Context *ctx,cJSON *item,int recurse);
+
+/* A recycling pool for one context. Freed blocks of up to 1024 bytes (nodes, strings, small print buffers) are kept on
+   free lists, one per power-of-two size class from 16 bytes, and handed out again, so parsing and deleting a stream of
+   similar documents stops calling malloc once the lists are warm. Like the context it belongs to, use it from one thread at a time. */
+#define cJSON_POOL_CLASSES 7
+typedef struct cJSON_Pool {
+	void *(*malloc_fn)(void *userdata,size_t sz);	/* The allocator behind the pool: the context's, when the pool was installed. */
+	void (*free_fn)(void *userdata,void *ptr);
+	void *userdata;
+	void *lists[cJSON_POOL_CLASSES];	/* Free blocks, per size class. */
+	int counts[cJSON_POOL_CLASSES];		/* Blocks on each list. */
+	int cap;							/* Most free blocks kept per size class; the rest go straight back to free_fn. */
+	unsigned long hits,misses;			/* Allocations served from the lists / passed on to malloc_fn. */
+} cJSON_Pool;
+
+/* Put pool in front of ctx's allocator. Do this before anything is allocated through ctx. */
+extern void cJSON_InitPool(cJSON_Pool *pool,cJSON_Context *ctx,int cap);
+/* Hand free blocks back until at most keep are left per size class. cJSON_TrimPool(pool,0) empties the pool; do that before dropping it. */
+extern void cJSON_TrimPool(cJSON_Pool *pool,int keep);
+
 
 /* Supply a block of JSON, and this returns a cJSON object you can interrogate. Call cJSON_Delete when finished. */
 extern cJSON *cJSON_Parse(const char *value);
@@ -77,6 +157,26 @@ extern cJSON *cJSON_GetArrayItem(cJSON *array,int item);
 /* Get item "string" from object. Case insensitive. */
 extern cJSON *cJSON_GetObjectItem(cJSON *object,const char *string);
 
+/* A key for cJSON_GetObjectItems, with its length and hash worked out once by cJSON_CompileKeys.
+   Build tables with cJSON_KEY, e.g. static cJSON_Key keys[]={cJSON_KEY("id"),cJSON_KEY("name")}; and compile them before first use.
+   Keys that were never compiled still match, but by a full cJSON_strcasecmp against every member. */
+typedef struct cJSON_Key {
+	const char *string;
+	size_t length;
+	unsigned hash;
+} cJSON_Key;
+#define cJSON_KEY(s)	{s,0,0}
+/* The hash cJSON_CompileKeys stores: FNV-1a over the key with ASCII letters lower-cased, one byte c at a time from
+   cJSON_KEY_HASH_SEED. inc/cJSON_Reflect.hpp works out the same hash at compile time. c is evaluated more than once. */
+#define cJSON_KEY_HASH_SEED 2166136261u
+#define cJSON_KEY_HASH_STEP(h,c)	((uint32_t)(((uint32_t)(h) ^ (uint32_t)(unsigned char)(((c) >= 'A' && (c) <= 'Z') ? (c) - 'A' + 'a' : (c))) * 16777619u))
+extern void cJSON_CompileKeys(cJSON_Key *keys,int count);
+/* Look up count keys in one walk over object, stopping as soon as all are found. items[i] gets what cJSON_GetObjectItem(object,keys[i].string)
+   would return (case insensitive, first match), or 0. Returns the number of keys found.
+   Each member is hashed once and checked against the keys still missing, so the cost is members*keys hash compares: meant for
+   the handful of keys a caller reads at once, not for large tables. */
+extern int cJSON_GetObjectItems(cJSON *object,const cJSON_Key *keys,int count,cJSON **items);
+
 /* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when cJSON_Parse() returns 0. 0 when cJSON_Parse() succeeds. */
 extern const char *cJSON_GetErrorPtr(void);
 	
@@ -85,21 +185,54 @@ extern cJSON *cJSON_CreateNull(void);
 extern cJSON *cJSON_CreateTrue(void);
 extern cJSON *cJSON_CreateFalse(void);
 extern cJSON *cJSON_CreateBool(int b);
-extern cJSON *cJSON_CreateNumber(double num);
+extern cJSON *cJSON_CreateNumber(cJSON_number num);
 extern cJSON *cJSON_CreateString(const char *string);
+/* Borrow string instead of copying it. Like the key passed to cJSON_AddItemToObjectCS, it must stay valid and unchanged for as long as the item,
+   or any cJSON_Duplicate of it, is alive: cJSON_Delete never frees a borrowed string and cJSON_Duplicate shares it rather than copying. */
+extern cJSON *cJSON_CreateStringCS(const char *string);
 extern cJSON *cJSON_CreateArray(void);
 extern cJSON *cJSON_CreateObject(void);
 
 /* These utilities create an Array of count items. */
 extern cJSON *cJSON_CreateIntArray(const int *numbers,int count);
+#ifndef cJSON_NO_FLOAT
 extern cJSON *cJSON_CreateFloatArray(const float *numbers,int count);
 extern cJSON *cJSON_CreateDoubleArray(const double *numbers,int count);
+#endif
 extern cJSON *cJSON_CreateStringArray(const char **strings,int count);
 
+/* Packed arrays keep their numbers in one buffer: 4 or 8 bytes an element instead of a node each.
+   They print, compare, hash, duplicate and delete like the equivalent array of numbers, and cJSON_GetArraySize counts them,
+   but they have no child nodes: walk them with cJSON_GetPackedArray, or call cJSON_UnpackArray first.
+   Adding, inserting, replacing or detaching an item unpacks the array. */
+extern cJSON *cJSON_CreatePackedInt32Array(const int32_t *numbers,int count);
+extern cJSON *cJSON_CreatePackedInt64Array(const int64_t *numbers,int count);
+#ifndef cJSON_NO_FLOAT
+extern cJSON *cJSON_CreatePackedDoubleArray(const double *numbers,int count);
+#endif
+/* Zero-copy access: returns the element buffer (int32_t, int64_t or double, see array->type & cJSON_IsPacked) and stores the count. 0 if array is not packed. */
+extern void  *cJSON_GetPackedArray(cJSON *array,int *count);
+/* Turn a packed array into an ordinary array of number nodes, allocated from the context the array was parsed or duplicated
+   with (the hooks for cJSON_CreatePacked*), so the tree keeps one allocator. Returns 0 on memory failure, leaving array untouched. */
+extern int    cJSON_UnpackArray(cJSON *array);
+
+/* Binary values keep raw bytes and print them as a base64 string, encoded straight into the output. They compare, hash
+   and freeze like that string, and a duplicate copies the bytes. valuestring is not text, so test for cJSON_StringIsBinary
+   before reading it as a string. cJSON_CreateBinaryCS borrows data, which must outlive the item. */
+extern cJSON *cJSON_CreateBinary(const void *data,int size);
+extern cJSON *cJSON_CreateBinaryCS(const void *data,int size);
+/* Zero-copy access: returns the bytes and stores their count. A base64 string, e.g. one just parsed, is decoded in place
+   first and becomes a binary value, so nothing is allocated. 0, with item untouched, for anything else (and for references
+   and borrowed strings, which are not the item's to overwrite: use cJSON_DecodeBinary). */
+extern void  *cJSON_GetBinary(cJSON *item,int *size);
+/* Decode a binary value or base64 string into buffer, which holds size bytes. Returns the byte count, or -1 if item is
+   neither or the bytes do not fit. With buffer 0 it returns the count without decoding. */
+extern int    cJSON_DecodeBinary(cJSON *item,void *buffer,int size);
+
 /* Append item to the specified array/object. */
 extern void cJSON_AddItemToArray(cJSON *array, cJSON *item);
 extern void	cJSON_AddItemToObject(cJSON *object,const char *string,cJSON *item);
-extern void	cJSON_AddItemToObjectCS(cJSON *object,const char *string,cJSON *item);	/* Use this when string is definitely const (i.e. a literal, or as good as), and will definitely survive the cJSON object */
+extern void	cJSON_AddItemToObjectCS(cJSON *object,const char *string,cJSON *item);	/* Use this when string is definitely const (i.e. a literal, or as good as), and will definitely survive the cJSON object and its duplicates */
 /* Append reference to item to the specified array/object. Use this when you want to add an existing cJSON to a new cJSON, but don't want to corrupt your existing cJSON. */
 extern void cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item);
 extern void	cJSON_AddItemReferenceToObject(cJSON *object,const char *string,cJSON *item);
@@ -114,6 +247,13 @@ extern void   cJSON_DeleteItemFromObject(cJSON *object,const char *string);
 extern void cJSON_InsertItemInArray(cJSON *array,int which,cJSON *newitem);	/* Shifts pre-existing items to the right. */
 extern void cJSON_ReplaceItemInArray(cJSON *array,int which,cJSON *newitem);
 extern void cJSON_ReplaceItemInObject(cJSON *object,const char *string,cJSON *newitem);
+/* Put replacement where item is in parent, under item's key, and delete item. */
+extern void cJSON_ReplaceItemViaPointer(cJSON *parent,cJSON *item,cJSON *replacement);
+/* Give a string item a copy of valuestring as its new value. Returns the copy, or 0 if item is not a string or on memory failure. */
+extern char *cJSON_SetValuestring(cJSON *item,const char *valuestring);
+/* Give item the type and value of value (children, number, string) in place, keeping item's key and its place in its
+   parent, and delete value. For replacing a root that others hold a pointer to. Returns 0, with both untouched, on memory failure. */
+extern int cJSON_ReplaceValue(cJSON *item,cJSON *value);
 
 /* Duplicate a cJSON item */
 extern cJSON *cJSON_Duplicate(cJSON *item,int recurse);
@@ -121,11 +261,184 @@ extern cJSON *cJSON_Duplicate(cJSON *item,int recurse);
 need to be released. With recurse!=0, it will duplicate any children connected to the item.
 The item->next and ->prev pointers are always zero on return from Duplicate. */
 
+/* Deep equality: same types, numbers, strings and keys (case sensitive). Returns 1 when equal.
+   With ignore_order!=0 objects match whatever order their members are in. */
+extern int cJSON_Compare(cJSON *a,cJSON *b,int ignore_order);
+/* 64-bit structural hash in one pass, without allocating. It ignores object member order, so items that
+   cJSON_Compare(a,b,1) calls equal hash the same, and it is the same on every platform. */
+extern uint64_t cJSON_Hash(cJSON *item);
+/* cJSON_Hash with the children's hashes supplied by child_hash(arg,child), called once per child in order. For code that
+   hashes every node of a tree in one bottom-up pass (cJSON_Utils does); cJSON_Hash(item) is cJSON_HashWith(item,<cJSON_Hash>,0). */
+extern uint64_t cJSON_HashWith(cJSON *item,uint64_t (*child_hash)(void *arg,cJSON *child),void *arg);
+/* Render without formatting and with object members sorted by key (byte order), so equal documents print the same. Free the char* when finished. */
+extern char  *cJSON_PrintCanonical(cJSON *item);
+
+/* Frozen trees: a read-only copy of a tree in one block, for data that is parsed once and read by many threads.
+   Nothing in it is ever written after cJSON_Freeze returns, so any number of threads can walk it at once without a lock.
+   Children sit side by side, so arrays index in O(1), and objects carry their members sorted by key for binary search. */
+typedef struct cJSON_Frozen {
+	int type;								/* cJSON_False..cJSON_Object, without the flag bits. Packed arrays freeze as arrays of numbers, binary values as their base64 text. */
+	int count;								/* Arrays and objects: the number of children. */
+	const char *string;						/* The key, for object members. */
+	const char *valuestring;
+	int valueint;
+	cJSON_number valuedouble;
+	const struct cJSON_Frozen *child;		/* Arrays and objects: child[0..count-1], in document order. */
+	const struct cJSON_Frozen *const *index;	/* Objects: the children sorted by key, case insensitively. */
+} cJSON_Frozen;
+
+/* Copy item into one block. Returns 0 on memory failure. Release it with cJSON_FreeFrozen, or ctx->free_fn for the context version. */
+extern const cJSON_Frozen *cJSON_Freeze(cJSON *item);
+extern const cJSON_Frozen *cJSON_FreezeWithContext(cJSON_Context *ctx,cJSON *item);
+extern void cJSON_FreeFrozen(const cJSON_Frozen *frozen);
+/* Lookups. They return the same item cJSON_GetArrayItem/cJSON_GetObjectItem would on the original tree, or 0. */
+extern const cJSON_Frozen *cJSON_GetFrozenArrayItem(const cJSON_Frozen *array,int item);
+extern const cJSON_Frozen *cJSON_GetFrozenObjectItem(const cJSON_Frozen *object,const char *string);
+
+/* Publishing new versions, RCU style. Readers bracket their use of the current version with cJSON_AcquireFrozen/cJSON_ReleaseFrozen,
+   which never wait. cJSON_PublishFrozen swaps in a new version, waits until every reader that may still see the old one has
+   released it, and hands the old one back to be freed. Publish from one thread at a time. */
+typedef struct cJSON_FrozenSlot {
+	const cJSON_Frozen *volatile current;
+	volatile unsigned long epoch;			/* Bumped by every publish. */
+	volatile long readers[2];				/* Readers inside, per epoch parity. */
+} cJSON_FrozenSlot;
+
+extern void cJSON_InitFrozenSlot(cJSON_FrozenSlot *slot,const cJSON_Frozen *frozen);
+/* Returns the current version. Pass the ticket to cJSON_ReleaseFrozen once done with it. */
+extern const cJSON_Frozen *cJSON_AcquireFrozen(cJSON_FrozenSlot *slot,int *ticket);
+extern void cJSON_ReleaseFrozen(cJSON_FrozenSlot *slot,int ticket);
+extern const cJSON_Frozen *cJSON_PublishFrozen(cJSON_FrozenSlot *slot,const cJSON_Frozen *frozen);
+
 /* ParseWithOpts allows you to require (and check) that the JSON is null terminated, and to retrieve the pointer to the final byte parsed. */
 extern cJSON *cJSON_ParseWithOpts(const char *value,const char **return_parse_end,int require_null_terminated);
+/* The same for text that is not null terminated, such as a network or DMA buffer: nothing from value+length on is read,
+   and a NUL byte before that ends the text too. require_null_terminated then means nothing but whitespace up to length.
+   The parse end and the error pointer can be value+length, so check them before reading through them. */
+extern cJSON *cJSON_ParseWithLength(const char *value,size_t length);
+extern cJSON *cJSON_ParseWithLengthOpts(const char *value,size_t length,const char **return_parse_end,int require_null_terminated);
 
 extern void cJSON_Minify(char *json);
 
+/* Text primitives: the scanners and formatters behind the parser and printer, for code that maps JSON onto its own
+   types (inc/cJSON_Reflect.hpp does). None of them allocates. */
+extern const char *cJSON_SkipWhitespace(const char *in);
+/* Step over the value at value without building it. Returns 0 if it is malformed. */
+extern const char *cJSON_SkipValue(const char *value);
+/* Read the number at num and return the end of it. cJSON_ScanInteger only takes exact integers of up to 18 digits and returns 0 for anything else. */
+extern const char *cJSON_ScanNumber(const char *num,cJSON_number *out);
+extern const char *cJSON_ScanInteger(const char *num,int64_t *out);
+/* Unescape the string literal at str (its opening quote) into out, which holds cJSON_ScanStringSize(str) bytes. Returns the end of the literal, 0 if str is not one. */
+extern int cJSON_ScanStringSize(const char *str);
+extern const char *cJSON_ScanString(const char *str,char *out);
+/* Write d, or str quoted and escaped, at out exactly as cJSON_Print would, terminate it and return the end.
+   out must hold cJSON_NUMBER_SPACE bytes, or cJSON_STRING_SPACE(strlen(str)). */
+#define cJSON_NUMBER_SPACE 64
+#define cJSON_STRING_SPACE(len) ((len)*6+16)
+extern char *cJSON_FormatNumber(char *out,cJSON_number d);
+extern char *cJSON_FormatString(char *out,const char *str);
+/* Write size bytes at out as a quoted base64 string. out holds cJSON_BINARY_SPACE(size) bytes. */
+#define cJSON_BINARY_SPACE(size) (((size)+2)/3*4+3)
+extern char *cJSON_FormatBinary(char *out,const void *data,int size);
+/* Decode the base64 string literal at str straight into out, which holds size bytes, and store the byte count.
+   Returns the end of the literal, or 0 if it is not base64 (escapes included) or does not fit. */
+extern const char *cJSON_ScanBinary(const char *str,void *out,int size,int *count);
+/* Write v in decimal at out, which holds cJSON_NUMBER_SPACE bytes, with all its digits. Same text as cJSON_FormatNumber for values that fit an int. */
+extern char *cJSON_FormatInteger(char *out,int64_t v);
+
+/* Struct codec: map JSON objects straight onto C structs through a table of fields, without building cJSON nodes. */
+#define cJSON_FieldInt 0		/* int; numbers that are not whole or do not fit fail the parse */
+#define cJSON_FieldDouble 1		/* double */
+#define cJSON_FieldFloat 2		/* float; numbers beyond FLT_MAX fail the parse */
+#define cJSON_FieldBool 3		/* int, 0 or 1 */
+#define cJSON_FieldString 4		/* char *, allocated while parsing; must start out 0 (or owned by the context), release with cJSON_FreeStruct */
+#define cJSON_FieldChars 5		/* char[N] inside the struct; strings that do not fit fail the parse */
+#define cJSON_FieldObject 6		/* nested struct, described by fields/count */
+#define cJSON_FieldArray 7		/* fixed capacity array; fields points at one element descriptor, count is the capacity */
+
+typedef struct cJSON_Field {
+	const char *key;				/* JSON key. Matched case insensitively, like cJSON_GetObjectItem. */
+	int type;						/* cJSON_Field* */
+	size_t offset;					/* offsetof() the member */
+	size_t size;					/* sizeof() the member, or of one element for element descriptors */
+	const struct cJSON_Field *fields;	/* nested fields (object) or element descriptor (array) */
+	int count;						/* number of nested fields, or array capacity */
+	size_t count_offset;			/* arrays: offsetof() the int that holds the number of items */
+} cJSON_Field;
+
+/* Use these to build field tables, e.g. cJSON_Field rec[]={cJSON_FIELD("City",cJSON_FieldString,struct record,city), ...}; */
+#define cJSON_FIELD(key,kind,type,member)	{key,kind,offsetof(type,member),sizeof(((type *)0)->member),0,0,0}
+#define cJSON_FIELD_OBJECT(key,type,member,fields)	{key,cJSON_FieldObject,offsetof(type,member),sizeof(((type *)0)->member),fields,sizeof(fields)/sizeof(*(fields)),0}
+#define cJSON_FIELD_ARRAY(key,type,member,countmember,element)	{key,cJSON_FieldArray,offsetof(type,member),sizeof(((type *)0)->member),&(element),sizeof(((type *)0)->member)/sizeof(*((type *)0)->member),offsetof(type,countmember)}
+/* Element descriptors for cJSON_FIELD_ARRAY. */
+#define cJSON_ELEMENT(kind,ctype)			{0,kind,0,sizeof(ctype),0,0,0}
+#define cJSON_ELEMENT_OBJECT(ctype,fields)	{0,cJSON_FieldObject,0,sizeof(ctype),fields,sizeof(fields)/sizeof(*(fields)),0}
+
+/* Parse a JSON object into the struct at out. Unknown keys are skipped, missing keys and nulls leave members untouched. Returns 0 on failure, see cJSON_GetErrorPtr. */
+extern int cJSON_ParseStruct(const char *value,const cJSON_Field *fields,int count,void *out);
+/* Render the struct at in as a JSON object, formatted exactly like cJSON_Print (fmt=1) or cJSON_PrintUnformatted (fmt=0) would render the equivalent tree. Free the char* when finished. */
+extern char *cJSON_PrintStruct(const void *in,const cJSON_Field *fields,int count,int fmt);
+/* Release the cJSON_FieldString members allocated by cJSON_ParseStruct. */
+extern void cJSON_FreeStruct(void *in,const cJSON_Field *fields,int count);
+/* The same, allocating from (and reporting errors to) ctx. */
+extern int cJSON_ParseStructWithContext(cJSON_Context *ctx,const char *value,const cJSON_Field *fields,int count,void *out);
+extern char *cJSON_PrintStructWithContext(cJSON_Context *ctx,const void *in,const cJSON_Field *fields,int count,int fmt);
+extern void cJSON_FreeStructWithContext(cJSON_Context *ctx,void *in,const cJSON_Field *fields,int count);
+
+/* NDJSON reader: one JSON value per line, pulled through a read callback. Each record is parsed into an arena that is
+   reset, not freed, when the next one is read, so a stream of any length runs in the memory its largest record needs. */
+typedef int (*cJSON_ReadFn)(void *source,char *buffer,int size);	/* Returns the bytes read, 0 at end of stream, <0 on error. */
+typedef struct cJSON_Stream {
+	cJSON_ReadFn read_fn;
+	void *source;					/* Handed back to read_fn. */
+	cJSON_Context *parent;			/* Where the line buffer and arena blocks come from. */
+	cJSON_Context ctx;				/* Allocates from the arena. After a bad record, ctx.errorptr points into it. */
+	char *buffer;					/* Bytes read but not yet returned are [start,end); [start,scanned) holds no newline. */
+	size_t size,start,scanned,end;
+	void *blocks;					/* Arena blocks, newest first. */
+	char *top,*limit;				/* Free space left in the newest block. */
+	int eof;
+	unsigned long line;				/* Line number of the last record returned. */
+} cJSON_Stream;
+
+/* Set s up to read from read_fn/source. The buffer and arena come from ctx (0 for the hooks), which also lends its flags.
+   s is referenced by its own context, so do not copy it. Returns 0 on memory failure. */
+extern int cJSON_InitStream(cJSON_Stream *s,cJSON_Context *ctx,cJSON_ReadFn read_fn,void *source);
+/* Parse the next non-blank line into *record. The record lives until the next call or cJSON_FreeStream; do not delete it.
+   Returns 1 for a record, 0 at end of stream, -1 for a line that is not one JSON value (it is skipped, so call again to go on)
+   and -2 on a read error or memory failure. */
+extern int cJSON_StreamNext(cJSON_Stream *s,cJSON **record);
+extern void cJSON_FreeStream(cJSON_Stream *s);
+/* A cJSON_ReadFn for a stdio FILE *. */
+extern int cJSON_ReadFile(void *file,char *buffer,int size);
+
+/* Print to a sink: the text is rendered into buffer, and each time buffer fills up it is handed to write_fn and reused,
+   so the memory used does not depend on the size of the document and the first bytes go out before the last are rendered.
+   Only a single string or number longer than buffer makes it grow, from the hooks (or ctx), for that token. No terminating null is written.
+   write_fn returns the bytes it took; anything less than size stops printing. Returns 1 on success, 0 on a write or memory failure. */
+typedef int (*cJSON_WriteFn)(void *sink,const char *data,int size);
+extern int cJSON_PrintToSink(cJSON *item,int fmt,char *buffer,int size,cJSON_WriteFn write_fn,void *sink);
+/* Same, with ctx's print flags and allocator. */
+extern int cJSON_PrintToSinkWithContext(cJSON_Context *ctx,cJSON *item,int fmt,char *buffer,int size,cJSON_WriteFn write_fn,void *sink);
+/* A cJSON_WriteFn for a stdio FILE *. */
+extern int cJSON_WriteFile(void *file,const char *data,int size);
+
+/* Parallel printing: the children of a big array or object are cut into pieces that print side by side, each into its own buffer,
+   and are then joined in order. The text is the same as cJSON_Print/cJSON_PrintUnformatted give. cJSON has no threads of its own;
+   run hands the pieces to yours. The allocator (the hooks, or ctx's malloc_fn/free_fn) must be safe to call from those threads. */
+typedef void (*cJSON_ParallelFn)(void *pool,void (*job)(void *arg,int index),void *arg,int count);
+typedef struct cJSON_Parallel {
+	cJSON_ParallelFn run;		/* Calls job(arg,i) for every i in [0,count) on any threads, and returns when all of them have. */
+	void *pool;					/* Handed back to run. */
+	int threshold;				/* Arrays and objects with fewer children than this print serially. */
+	int jobs;					/* Pieces a bigger container is cut into. A few per thread evens out uneven children. */
+} cJSON_Parallel;
+
+/* Like cJSON_PrintBuffered/cJSON_PrintWithContext, with the first container of at least par->threshold children on the way down
+   printed in par->jobs pieces. Containers inside a piece print serially. */
+extern char *cJSON_PrintParallel(cJSON *item,int fmt,const cJSON_Parallel *par);
+extern char *cJSON_PrintParallelWithContext(cJSON_Context *ctx,cJSON *item,int fmt,const cJSON_Parallel *par);
+
 /* Macros for creating things quickly. */
 #define cJSON_AddNullToObject(object,name)		cJSON_AddItemToObject(object, name, cJSON_CreateNull())
 #define cJSON_AddTrueToObject(object,name)		cJSON_AddItemToObject(object, name, cJSON_CreateTrue())
@@ -133,6 +446,9 @@ extern void cJSON_Minify(char *json);
 #define cJSON_AddBoolToObject(object,name,b)	cJSON_AddItemToObject(object, name, cJSON_CreateBool(b))
 #define cJSON_AddNumberToObject(object,name,n)	cJSON_AddItemToObject(object, name, cJSON_CreateNumber(n))
 #define cJSON_AddStringToObject(object,name,s)	cJSON_AddItemToObject(object, name, cJSON_CreateString(s))
+#define cJSON_AddBinaryToObject(object,name,d,n)	cJSON_AddItemToObject(object, name, cJSON_CreateBinary(d, n))
+/* Borrowed key and value, no string is copied. Both must outlive the object. */
+#define cJSON_AddStringToObjectCS(object,name,s)	cJSON_AddItemToObjectCS(object, name, cJSON_CreateStringCS(s))
 
 /* When assigning an integer value, it needs to be propagated to valuedouble too. */
 #define cJSON_SetIntValue(object,val)			((object)?(object)->valueint=(object)->valuedouble=(val):(val))
@@ -0,0 +1,227 @@
+/*
+  Copyright (c) 2009 Dave Gamble
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#ifndef cJSON__hpp
+#define cJSON__hpp
+
+/* C++17 wrapper over the C API. It is header only and never allocates: Document owns a tree, and everything else
+   (Value, iterators, string_views) points into it, so views must not outlive their Document. */
+
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "cJSON.h"
+
+namespace cjson
+{
+
+/* Whether the number v converts to T: integers must be whole and in range, narrower floating types in range.
+   static_cast on anything else is undefined, so Value::get and cJSON_Reflect.hpp refuse those values. */
+template <class T, class V>
+bool fits(V v) noexcept
+{
+	using limits = std::numeric_limits<T>;
+	if constexpr (std::is_integral_v<T> && std::is_unsigned_v<V>)
+		return v <= static_cast<std::make_unsigned_t<T>>(limits::max());
+	else if constexpr (std::is_integral_v<T> && std::is_integral_v<V>)
+	{
+		if constexpr (std::is_signed_v<T>)
+			return v >= limits::min() && v <= limits::max();
+		else
+			return v >= 0 && static_cast<std::uint64_t>(v) <= limits::max();
+	}
+	else if constexpr (std::is_integral_v<T>)
+	{
+		V hi = std::ldexp(V(1), limits::digits); /* 2^digits is exact where max() would round */
+		return v == std::floor(v) && v < hi && v >= (std::is_signed_v<T> ? -hi : V(0));
+	}
+	else if constexpr (std::is_floating_point_v<V> && limits::max() < std::numeric_limits<V>::max())
+		return v >= -limits::max() && v <= limits::max();
+	else
+		return true;
+}
+
+/* Printed text, released the way the C API expects. */
+struct TextDeleter
+{
+	cJSON_Context *ctx;
+	void operator()(char *text) const noexcept
+	{
+		if (ctx)
+			ctx->free_fn(ctx->userdata, text);
+		else
+			std::free(text);
+	}
+};
+using Text = std::unique_ptr<char, TextDeleter>;
+
+/* A non-owning view of one item. A default or missing Value is null-safe: lookups on it give more missing Values
+   and get<T>() gives the fallback, so doc.root()["a"]["b"].get<int>() needs no checks along the way. */
+class Value
+{
+public:
+	class iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Value;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = Value;
+
+		explicit iterator(cJSON *item = nullptr) noexcept : item_(item) {}
+		Value operator*() const noexcept { return Value(item_); }
+		iterator &operator++() noexcept { item_ = item_->next; return *this; }
+		iterator operator++(int) noexcept { iterator old = *this; item_ = item_->next; return old; }
+		bool operator==(const iterator &other) const noexcept { return item_ == other.item_; }
+		bool operator!=(const iterator &other) const noexcept { return item_ != other.item_; }
+
+	private:
+		cJSON *item_;
+	};
+
+	Value() noexcept : item_(nullptr) {}
+	explicit Value(cJSON *item) noexcept : item_(item) {}
+
+	cJSON *get() const noexcept { return item_; }
+	explicit operator bool() const noexcept { return item_ != nullptr; }
+	/* cJSON_False..cJSON_Object without the flag bits, or -1 for a missing Value. */
+	int type() const noexcept { return item_ ? (item_->type & 255) : -1; }
+	bool is_null() const noexcept { return type() == cJSON_NULL; }
+	bool is_bool() const noexcept { return type() == cJSON_False || type() == cJSON_True; }
+	bool is_number() const noexcept { return type() == cJSON_Number; }
+	bool is_string() const noexcept { return type() == cJSON_String; }
+	bool is_array() const noexcept { return type() == cJSON_Array; }
+	bool is_object() const noexcept { return type() == cJSON_Object; }
+
+	/* The member name, for items inside an object. */
+	std::string_view key() const noexcept { return (item_ && item_->string) ? std::string_view(item_->string) : std::string_view(); }
+	int size() const noexcept { return (is_array() || is_object()) ? cJSON_GetArraySize(item_) : 0; }
+	/* Case insensitive, like cJSON_GetObjectItem. */
+	Value operator[](const char *key) const noexcept { return Value(is_object() ? cJSON_GetObjectItem(item_, key) : nullptr); }
+	Value operator[](int index) const noexcept { return Value((is_array() || is_object()) ? cJSON_GetArrayItem(item_, index) : nullptr); }
+
+	/* Children of an array or object, in order. Packed arrays have no child nodes: read them with packed(). */
+	iterator begin() const noexcept { return iterator((is_array() || is_object()) ? item_->child : nullptr); }
+	iterator end() const noexcept { return iterator(); }
+
+	/* The element buffer of a packed array and its count, see cJSON_GetPackedArray. */
+	const void *packed(int *count) const noexcept { return item_ ? cJSON_GetPackedArray(item_, count) : nullptr; }
+	/* The bytes of a binary value, or of a base64 string after decoding it in place; see cJSON_GetBinary. */
+	const void *binary(int *size) const noexcept { return item_ ? cJSON_GetBinary(item_, size) : nullptr; }
+
+	/* bool, any arithmetic type, std::string_view or const char *. Gives fallback when the item is missing or of another type
+	   (strings also when they are binary values), and for numbers that T cannot hold, see fits. */
+	template <class T>
+	T get(T fallback = T()) const noexcept
+	{
+		if constexpr (std::is_same_v<T, bool>)
+			return (type() == cJSON_True) ? true : (type() == cJSON_False) ? false : fallback;
+		else if constexpr (std::is_arithmetic_v<T>)
+			return (is_number() && fits<T>(item_->valuedouble)) ? static_cast<T>(item_->valuedouble) : fallback;
+		else if constexpr (std::is_same_v<T, std::string_view>)
+			return is_text() ? std::string_view(item_->valuestring) : fallback;
+		else if constexpr (std::is_same_v<T, const char *>)
+			return is_text() ? item_->valuestring : fallback;
+		else
+			static_assert(!sizeof(T), "cjson::Value::get: unsupported type");
+	}
+
+	/* cJSON_Print/cJSON_PrintUnformatted. Empty on memory failure. */
+	Text print(bool formatted = true) const noexcept
+	{
+		return Text(item_ ? (formatted ? cJSON_Print(item_) : cJSON_PrintUnformatted(item_)) : nullptr, TextDeleter{nullptr});
+	}
+
+private:
+	/* A string with text in it: binary values hold bytes, read them with binary(). */
+	bool is_text() const noexcept { return is_string() && item_->valuestring && !(item_->type & cJSON_StringIsBinary); }
+
+	cJSON *item_;
+};
+
+/* Owns a tree and deletes it, through the context it was parsed with if there is one. Move-only. */
+class Document
+{
+public:
+	Document() noexcept : root_(nullptr), ctx_(nullptr) {}
+	/* Take over a tree built with the C API. */
+	explicit Document(cJSON *root, cJSON_Context *ctx = nullptr) noexcept : root_(root), ctx_(ctx) {}
+	Document(Document &&other) noexcept : root_(other.root_), ctx_(other.ctx_) { other.root_ = nullptr; }
+	Document &operator=(Document &&other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			root_ = std::exchange(other.root_, nullptr);
+			ctx_ = other.ctx_;
+		}
+		return *this;
+	}
+	Document(const Document &) = delete;
+	Document &operator=(const Document &) = delete;
+	~Document() { reset(); }
+
+	/* text must be null terminated. On failure the Document is empty; see cJSON_GetErrorPtr, or ctx.errorptr. */
+	static Document parse(const char *text) noexcept { return Document(cJSON_Parse(text)); }
+	static Document parse(cJSON_Context &ctx, const char *text) noexcept { return Document(cJSON_ParseWithContext(&ctx, text, nullptr), &ctx); }
+
+	explicit operator bool() const noexcept { return root_ != nullptr; }
+	Value root() const noexcept { return Value(root_); }
+	Value operator[](const char *key) const noexcept { return root()[key]; }
+	Value operator[](int index) const noexcept { return root()[index]; }
+	cJSON *get() const noexcept { return root_; }
+	/* Hand the tree back to the caller, who then deletes it. */
+	cJSON *release() noexcept { return std::exchange(root_, nullptr); }
+
+	Text print(bool formatted = true) const noexcept
+	{
+		if (!ctx_ || !root_)
+			return root().print(formatted);
+		return Text(cJSON_PrintWithContext(ctx_, root_, formatted), TextDeleter{ctx_});
+	}
+
+	void reset() noexcept
+	{
+		if (!root_)
+			return;
+		if (ctx_)
+			cJSON_DeleteWithContext(ctx_, root_);
+		else
+			cJSON_Delete(root_);
+		root_ = nullptr;
+	}
+
+private:
+	cJSON *root_;
+	cJSON_Context *ctx_;
+};
+
+}
+
+#endif
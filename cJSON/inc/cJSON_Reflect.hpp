@@ -0,0 +1,425 @@
+/*
+  Copyright (c) 2009 Dave Gamble
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#ifndef cJSON_Reflect__hpp
+#define cJSON_Reflect__hpp
+
+/* Compile-time struct codec for C++17. CJSON_REFLECT registers a struct, and cjson::parse/cjson::print then map it to and
+   from JSON through code generated for that struct alone: no field table is interpreted at run time. Keys are matched
+   on a length and hash worked out by the compiler, and values are read and written with cJSON's own scanners and
+   formatters straight into the destination, without building nodes.
+
+	struct Point { int x, y; std::string label; std::vector<double> weights; };
+	CJSON_REFLECT(Point, x, y, label, weights)
+
+   Register the struct at namespace scope, in its own namespace. Members can be bool, arithmetic types, std::string,
+   std::vector of any of these, or other registered structs, up to 32 per struct. As with cJSON_ParseStruct, keys match
+   case insensitively, unknown keys are skipped, and missing keys and nulls leave members as they were. A number the
+   member cannot hold (out of range, or a fraction for an integer member) fails the parse.
+   In cJSON_NO_FLOAT builds floating point members only carry whole numbers. */
+
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "cJSON.hpp"
+
+namespace cjson
+{
+namespace reflect
+{
+
+constexpr char lower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+/* The cJSON_Key hash (cJSON_KEY_HASH_STEP), so that keys differing only in case hash the same. */
+constexpr std::uint32_t key_hash(const char *key, std::size_t length)
+{
+	std::uint32_t h = cJSON_KEY_HASH_SEED;
+	for (std::size_t i = 0; i < length; i++)
+		h = cJSON_KEY_HASH_STEP(h, key[i]);
+	return h;
+}
+
+constexpr std::size_t key_length(const char *key)
+{
+	std::size_t n = 0;
+	while (key[n])
+		n++;
+	return n;
+}
+
+inline bool key_equal(const char *a, const char *b, std::size_t length)
+{
+	for (std::size_t i = 0; i < length; i++)
+		if (lower(a[i]) != lower(b[i]))
+			return false;
+	return true;
+}
+
+template <class T, class M>
+struct Field
+{
+	const char *key;
+	std::size_t length;
+	std::uint32_t hash;
+	M T::*member;
+};
+
+template <class T, class M>
+constexpr Field<T, M> field(const char *key, M T::*member) { return Field<T, M>{key, key_length(key), key_hash(key, key_length(key)), member}; }
+
+/* The key table of a registered struct, evaluated by the compiler. */
+template <class T>
+struct Fields
+{
+	static constexpr auto value = cjson_fields(static_cast<const T *>(nullptr));
+	static constexpr std::size_t count = std::tuple_size<std::remove_const_t<decltype(value)>>::value;
+};
+
+template <class T, class = void>
+struct is_reflected : std::false_type {};
+template <class T>
+struct is_reflected<T, std::void_t<decltype(cjson_fields(static_cast<const T *>(nullptr)))>> : std::true_type {};
+
+template <class T>
+struct is_vector : std::false_type {};
+template <class T, class A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+/* cJSON_ScanInteger stops at 18 digits, 64-bit members need up to 20. Reads a plain integer of any length into its sign and
+   magnitude, or returns nullptr for fractions, exponents and anything past UINT64_MAX. */
+inline const char *scan_wide_integer(const char *in, bool &negative, std::uint64_t &magnitude)
+{
+	std::uint64_t m = 0;
+	negative = (*in == '-');
+	in += negative;
+	if (*in < '0' || *in > '9')
+		return nullptr;
+	for (; *in >= '0' && *in <= '9'; in++)
+	{
+		if (m > (UINT64_MAX - static_cast<unsigned>(*in - '0')) / 10)
+			return nullptr;
+		m = m * 10 + static_cast<unsigned>(*in - '0');
+	}
+	if (*in == '.' || *in == 'e' || *in == 'E')
+		return nullptr;
+	magnitude = m;
+	return in;
+}
+
+template <class T>
+const char *parse_value(const char *in, T &out);
+
+template <class T, std::size_t... I>
+const char *parse_member(const char *in, T &out, const char *key, std::size_t length, std::uint32_t hash, std::index_sequence<I...>)
+{
+	const char *end = nullptr;
+	bool found = ((std::get<I>(Fields<T>::value).hash == hash && std::get<I>(Fields<T>::value).length == length &&
+				   key_equal(std::get<I>(Fields<T>::value).key, key, length) &&
+				   (end = parse_value(in, out.*(std::get<I>(Fields<T>::value).member)), true)) || ...);
+	return found ? end : cJSON_SkipValue(in);
+}
+
+template <class T>
+const char *parse_object(const char *in, T &out)
+{
+	const char *key, *end;
+	char unescaped[64];
+	std::size_t length;
+	if (*in != '{')
+		return nullptr;
+	in = cJSON_SkipWhitespace(in + 1);
+	if (*in == '}')
+		return in + 1;
+	for (;;)
+	{
+		if (*in != '\"')
+			return nullptr;
+		key = end = in + 1;
+		while (*end && *end != '\"' && *end != '\\')
+			end++;
+		if (*end == '\"')
+			length = end++ - key;
+		else if (cJSON_ScanStringSize(in) <= static_cast<int>(sizeof(unescaped)))
+		{
+			/* An escaped key: match on what it stands for. Longer ones cannot be a member name. */
+			end = cJSON_ScanString(in, unescaped);
+			key = unescaped;
+			length = std::strlen(unescaped);
+		}
+		else
+		{
+			end = cJSON_SkipValue(in);
+			key = nullptr;
+			length = 0;
+		}
+		if (!end)
+			return nullptr;
+		in = cJSON_SkipWhitespace(end);
+		if (*in != ':')
+			return nullptr;
+		in = cJSON_SkipWhitespace(in + 1);
+		if constexpr (Fields<T>::count == 0)
+			in = cJSON_SkipValue(in);
+		else if (key)
+			in = parse_member(in, out, key, length, key_hash(key, length), std::make_index_sequence<Fields<T>::count>());
+		else
+			in = cJSON_SkipValue(in);
+		if (!in)
+			return nullptr;
+		in = cJSON_SkipWhitespace(in);
+		if (*in == '}')
+			return in + 1;
+		if (*in != ',')
+			return nullptr;
+		in = cJSON_SkipWhitespace(in + 1);
+	}
+}
+
+template <class T>
+const char *parse_value(const char *in, T &out)
+{
+	if (!std::strncmp(in, "null", 4))
+		return in + 4;
+	if constexpr (std::is_same_v<T, bool>)
+	{
+		if (!std::strncmp(in, "true", 4))
+			return out = true, in + 4;
+		if (!std::strncmp(in, "false", 5))
+			return out = false, in + 5;
+		return nullptr;
+	}
+	else if constexpr (std::is_arithmetic_v<T>)
+	{
+		std::int64_t i;
+		cJSON_number d;
+		const char *end;
+		if (*in != '-' && (*in < '0' || *in > '9'))
+			return nullptr;
+		if constexpr (std::is_integral_v<T>)
+		{
+			bool negative;
+			std::uint64_t m;
+			if ((end = cJSON_ScanInteger(in, &i)))
+				return fits<T>(i) ? (out = static_cast<T>(i), end) : nullptr;
+			if ((end = scan_wide_integer(in, negative, m)))
+			{
+				if (!negative)
+					return fits<T>(m) ? (out = static_cast<T>(m), end) : nullptr;
+				if (m > static_cast<std::uint64_t>(INT64_MAX) + 1)
+					return nullptr;
+				i = (m == static_cast<std::uint64_t>(INT64_MAX) + 1) ? INT64_MIN : -static_cast<std::int64_t>(m);
+				return fits<T>(i) ? (out = static_cast<T>(i), end) : nullptr;
+			}
+		}
+		end = cJSON_ScanNumber(in, &d);
+		if (!end || !fits<T>(d))
+			return nullptr;
+		out = static_cast<T>(d);
+		return end;
+	}
+	else if constexpr (std::is_same_v<T, std::string>)
+	{
+		const char *end;
+		if (*in != '\"')
+			return nullptr;
+		out.resize(cJSON_ScanStringSize(in));
+		end = cJSON_ScanString(in, &out[0]);
+		out.resize(std::strlen(out.c_str()));
+		return end;
+	}
+	else if constexpr (is_vector<T>::value)
+	{
+		if (*in != '[')
+			return nullptr;
+		out.clear();
+		in = cJSON_SkipWhitespace(in + 1);
+		if (*in == ']')
+			return in + 1;
+		for (;;)
+		{
+			typename T::value_type element{};
+			in = parse_value(in, element);
+			if (!in)
+				return nullptr;
+			out.push_back(std::move(element));
+			in = cJSON_SkipWhitespace(in);
+			if (*in == ']')
+				return in + 1;
+			if (*in != ',')
+				return nullptr;
+			in = cJSON_SkipWhitespace(in + 1);
+		}
+	}
+	else
+	{
+		static_assert(is_reflected<T>::value, "cjson: member type is not supported; register it with CJSON_REFLECT");
+		return parse_object(in, out);
+	}
+}
+
+/* Printing appends to out, laid out exactly as cJSON_Print (formatted) or cJSON_PrintUnformatted would lay out the equivalent tree. */
+template <class T>
+void print_value(std::string &out, const T &in, int depth, bool fmt);
+
+template <class T, std::size_t... I>
+void print_members(std::string &out, const T &in, int depth, bool fmt, std::index_sequence<I...>)
+{
+	std::size_t last = sizeof...(I) - 1;
+	(((fmt ? (void)out.append(depth, '\t') : (void)0),
+	  out += '\"', out.append(std::get<I>(Fields<T>::value).key, std::get<I>(Fields<T>::value).length), out += fmt ? "\":\t" : "\":",
+	  print_value(out, in.*(std::get<I>(Fields<T>::value).member), depth, fmt),
+	  out += (I != last) ? (fmt ? ",\n" : ",") : (fmt ? "\n" : "")), ...);
+}
+
+/* Integer members are written with all their digits, so that they read back exactly; floating point ones as cJSON_Print would. */
+template <class T>
+char *print_number(char *out, T v)
+{
+	if constexpr (std::is_integral_v<T>)
+	{
+		if (std::is_signed_v<T> || static_cast<std::uint64_t>(v) <= INT64_MAX)
+			return cJSON_FormatInteger(out, static_cast<std::int64_t>(v));
+		/* Past INT64_MAX: everything but the last digit still fits. */
+		out = cJSON_FormatInteger(out, static_cast<std::int64_t>(v / 10));
+		*out++ = static_cast<char>('0' + v % 10);
+		*out = 0;
+		return out;
+	}
+	else
+		return cJSON_FormatNumber(out, static_cast<cJSON_number>(v));
+}
+
+template <class T>
+void print_value(std::string &out, const T &in, int depth, bool fmt)
+{
+	std::size_t n = out.size();
+	if constexpr (std::is_same_v<T, bool>)
+		out += in ? "true" : "false";
+	else if constexpr (std::is_arithmetic_v<T>)
+	{
+		out.resize(n + cJSON_NUMBER_SPACE);
+		out.resize(print_number(&out[n], in) - out.data());
+	}
+	else if constexpr (std::is_same_v<T, std::string>)
+	{
+		out.resize(n + cJSON_STRING_SPACE(in.size()));
+		out.resize(cJSON_FormatString(&out[n], in.c_str()) - out.data());
+	}
+	else if constexpr (is_vector<T>::value)
+	{
+		out += '[';
+		for (std::size_t i = 0; i < in.size(); i++)
+		{
+			if (i)
+				out += fmt ? ", " : ",";
+			print_value(out, static_cast<const typename T::value_type &>(in[i]), depth + 1, fmt);
+		}
+		out += ']';
+	}
+	else
+	{
+		static_assert(is_reflected<T>::value, "cjson: member type is not supported; register it with CJSON_REFLECT");
+		out += fmt ? "{\n" : "{";
+		if constexpr (Fields<T>::count > 0)
+		{
+			print_members(out, in, depth + 1, fmt, std::make_index_sequence<Fields<T>::count>());
+			if (fmt)
+				out.append(depth, '\t');
+		}
+		else if (fmt && depth > 0)
+			out.append(depth - 1, '\t');	/* cJSON_Print indents an empty object one tab less */
+		out += '}';
+	}
+}
+
+}
+
+/* Parse the object at text into out. Returns false on malformed input, leaving out partly filled. */
+template <class T>
+bool parse(const char *text, T &out)
+{
+	return text && reflect::parse_object(cJSON_SkipWhitespace(text), out) != nullptr;
+}
+
+/* Append in to out as JSON. Reusing out across calls keeps its capacity. */
+template <class T>
+void print(std::string &out, const T &in, bool formatted = true)
+{
+	reflect::print_value(out, in, 0, formatted);
+}
+
+template <class T>
+std::string print(const T &in, bool formatted = true)
+{
+	std::string out;
+	print(out, in, formatted);
+	return out;
+}
+
+}
+
+#define CJSON_REFLECT_EXPAND(x) x
+#define CJSON_REFLECT_F1(t, m) ::cjson::reflect::field(#m, &t::m)
+#define CJSON_REFLECT_F2(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F1(t, __VA_ARGS__))
+#define CJSON_REFLECT_F3(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F2(t, __VA_ARGS__))
+#define CJSON_REFLECT_F4(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F3(t, __VA_ARGS__))
+#define CJSON_REFLECT_F5(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F4(t, __VA_ARGS__))
+#define CJSON_REFLECT_F6(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F5(t, __VA_ARGS__))
+#define CJSON_REFLECT_F7(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F6(t, __VA_ARGS__))
+#define CJSON_REFLECT_F8(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F7(t, __VA_ARGS__))
+#define CJSON_REFLECT_F9(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F8(t, __VA_ARGS__))
+#define CJSON_REFLECT_F10(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F9(t, __VA_ARGS__))
+#define CJSON_REFLECT_F11(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F10(t, __VA_ARGS__))
+#define CJSON_REFLECT_F12(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F11(t, __VA_ARGS__))
+#define CJSON_REFLECT_F13(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F12(t, __VA_ARGS__))
+#define CJSON_REFLECT_F14(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F13(t, __VA_ARGS__))
+#define CJSON_REFLECT_F15(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F14(t, __VA_ARGS__))
+#define CJSON_REFLECT_F16(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F15(t, __VA_ARGS__))
+#define CJSON_REFLECT_F17(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F16(t, __VA_ARGS__))
+#define CJSON_REFLECT_F18(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F17(t, __VA_ARGS__))
+#define CJSON_REFLECT_F19(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F18(t, __VA_ARGS__))
+#define CJSON_REFLECT_F20(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F19(t, __VA_ARGS__))
+#define CJSON_REFLECT_F21(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F20(t, __VA_ARGS__))
+#define CJSON_REFLECT_F22(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F21(t, __VA_ARGS__))
+#define CJSON_REFLECT_F23(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F22(t, __VA_ARGS__))
+#define CJSON_REFLECT_F24(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F23(t, __VA_ARGS__))
+#define CJSON_REFLECT_F25(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F24(t, __VA_ARGS__))
+#define CJSON_REFLECT_F26(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F25(t, __VA_ARGS__))
+#define CJSON_REFLECT_F27(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F26(t, __VA_ARGS__))
+#define CJSON_REFLECT_F28(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F27(t, __VA_ARGS__))
+#define CJSON_REFLECT_F29(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F28(t, __VA_ARGS__))
+#define CJSON_REFLECT_F30(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F29(t, __VA_ARGS__))
+#define CJSON_REFLECT_F31(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F30(t, __VA_ARGS__))
+#define CJSON_REFLECT_F32(t, m, ...) CJSON_REFLECT_F1(t, m), CJSON_REFLECT_EXPAND(CJSON_REFLECT_F31(t, __VA_ARGS__))
+#define CJSON_REFLECT_PICK(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, name, ...) name
+#define CJSON_REFLECT_FIELDS(t, ...) CJSON_REFLECT_EXPAND(CJSON_REFLECT_PICK(__VA_ARGS__, CJSON_REFLECT_F32, CJSON_REFLECT_F31, CJSON_REFLECT_F30, CJSON_REFLECT_F29, CJSON_REFLECT_F28, CJSON_REFLECT_F27, CJSON_REFLECT_F26, CJSON_REFLECT_F25, CJSON_REFLECT_F24, CJSON_REFLECT_F23, CJSON_REFLECT_F22, CJSON_REFLECT_F21, CJSON_REFLECT_F20, CJSON_REFLECT_F19, CJSON_REFLECT_F18, CJSON_REFLECT_F17, CJSON_REFLECT_F16, CJSON_REFLECT_F15, CJSON_REFLECT_F14, CJSON_REFLECT_F13, CJSON_REFLECT_F12, CJSON_REFLECT_F11, CJSON_REFLECT_F10, CJSON_REFLECT_F9, CJSON_REFLECT_F8, CJSON_REFLECT_F7, CJSON_REFLECT_F6, CJSON_REFLECT_F5, CJSON_REFLECT_F4, CJSON_REFLECT_F3, CJSON_REFLECT_F2, CJSON_REFLECT_F1)(t, __VA_ARGS__))
+
+/* Register type and the members to map, in the order they are printed. */
+#define CJSON_REFLECT(type, ...) \
+	constexpr auto cjson_fields(const type *) { return std::make_tuple(CJSON_REFLECT_FIELDS(type, __VA_ARGS__)); }
+
+#endif
@@ -0,0 +1,71 @@
+/*
+  Copyright (c) 2009 Dave Gamble
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#ifndef cJSON_Utils__h
+#define cJSON_Utils__h
+
+#include "cJSON.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* Implement RFC6901 (https://tools.ietf.org/html/rfc6901) JSON Pointer spec. Object keys are matched case sensitively. */
+extern cJSON *cJSONUtils_GetPointer(cJSON *object,const char *pointer);
+
+/* Implement RFC6902 (https://tools.ietf.org/html/rfc6902) JSON Patch spec. */
+/* Packed arrays (cJSON_IsPacked) are diffed as a whole; pointers into one only resolve after cJSON_UnpackArray. */
+/* Returns an array of patch operations that turns "from" into "to". Equal subtrees are skipped by comparing 64-bit structural hashes, so the cost is dominated by the changed branches. */
+extern cJSON *cJSONUtils_GeneratePatches(cJSON *from,cJSON *to);
+/* Utility for generating patch array entries. The value is duplicated, so the caller keeps ownership of it. */
+extern void cJSONUtils_AddPatchToArray(cJSON *array,const char *op,const char *path,cJSON *value);
+/* Apply the patch array to object in place. Untouched nodes are left where they are. Returns 0 for success.
+   If an operation fails, the operations before it stay applied. */
+extern int cJSONUtils_ApplyPatches(cJSON *object,cJSON *patches);
+
+/* Implement RFC7386 (https://tools.ietf.org/html/rfc7386) JSON Merge Patch spec. */
+/* Merge patch into target in place and return the result. target is consumed and a new root is returned only when patch is not an object. */
+extern cJSON *cJSONUtils_MergePatch(cJSON *target,cJSON *patch);
+/* Returns the merge patch that turns "from" into "to", or 0 when they are equal. */
+extern cJSON *cJSONUtils_GenerateMergePatch(cJSON *from,cJSON *to);
+
+/* JSON Schema validation for a subset of the keywords: type, enum, minimum, maximum, exclusiveMinimum, exclusiveMaximum,
+   minLength, maxLength, items (one schema for every element), minItems, maxItems, properties, required, additionalProperties,
+   minProperties and maxProperties. The schema is compiled once into flat tables and can then check any number of documents,
+   from any number of threads. Compiling returns 0 if the schema is malformed or uses any other keyword; annotations such as
+   title or description are fine. Property names are matched case sensitively. */
+typedef struct cJSONUtils_Schema cJSONUtils_Schema;
+extern cJSONUtils_Schema *cJSONUtils_CompileSchema(cJSON *schema);
+extern void cJSONUtils_FreeSchema(cJSONUtils_Schema *schema);
+/* Returns 1 when item matches the schema. */
+extern int cJSONUtils_Validate(const cJSONUtils_Schema *schema,cJSON *item);
+/* Check JSON text without parsing it into a tree: one pass that scans the parts the schema does not constrain.
+   Returns 1 when text is one JSON value that matches. Otherwise returns 0 and, if fail is not 0, sets *fail to where
+   the text stopped matching or is malformed. Only an enum that lists arrays or objects makes it parse that one value. */
+extern int cJSONUtils_ValidateText(const cJSONUtils_Schema *schema,const char *text,const char **fail);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -32,9 +32,6 @@
 #include <ctype.h>
 #include "cJSON.h"
 
-static const char *ep;
-
-const char *cJSON_GetErrorPtr(void) { return ep; }
 /*
 cJSON_strcasecmp ַȽcompare
 ֵ 0:
@@ -62,6 +59,109 @@ static void *(*cJSON_malloc)(size_t sz) = malloc;
 /*庯ָcJSON_free,ָϵͳfree*/
 static void (*cJSON_free)(void *ptr) = free;
 
+/* The global context routes through the hooks above; cJSON_InitContext gives contexts plain malloc/free. */
+static void *hooks_malloc(void *userdata, size_t sz) { (void)userdata; return cJSON_malloc(sz); }
+static void hooks_free(void *userdata, void *ptr) { (void)userdata; cJSON_free(ptr); }
+static void *default_malloc(void *userdata, size_t sz) { (void)userdata; return malloc(sz); }
+static void default_free(void *userdata, void *ptr) { (void)userdata; free(ptr); }
+
+/* Used by every call that does not take a context. */
+static cJSON_Context global_context = {hooks_malloc, hooks_free, 0, 0, 0};
+
+static void *ctx_malloc(cJSON_Context *ctx, size_t sz) { return ctx->malloc_fn(ctx->userdata, sz); }
+static void ctx_free(cJSON_Context *ctx, void *ptr) { ctx->free_fn(ctx->userdata, ptr); }
+
+const char *cJSON_GetErrorPtr(void) { return global_context.errorptr; }
+
+void cJSON_InitContext(cJSON_Context *ctx)
+{
+	ctx->malloc_fn = default_malloc;
+	ctx->free_fn = default_free;
+	ctx->userdata = 0;
+	ctx->flags = 0;
+	ctx->errorptr = 0;
+}
+
+/* Pool blocks carry their size class in front, so that a free knows which list to go back to. */
+typedef union
+{
+	size_t cls;
+	void *align_p;
+	double align_d;
+} pool_header;
+
+/* Size class for sz: 0 for up to 16 bytes, 1 for up to 32, ... cJSON_POOL_CLASSES and up are not pooled. */
+static size_t pool_class(size_t sz)
+{
+	size_t cls = 0, size = 16;
+	while (size < sz && cls < cJSON_POOL_CLASSES)
+		size <<= 1, cls++;
+	return cls;
+}
+
+static void *pool_malloc(void *userdata, size_t sz)
+{
+	cJSON_Pool *pool = (cJSON_Pool *)userdata;
+	size_t cls = pool_class(sz);
+	pool_header *h;
+	if (cls < cJSON_POOL_CLASSES && pool->lists[cls])
+	{
+		h = (pool_header *)pool->lists[cls];
+		pool->lists[cls] = *(void **)(h + 1);
+		pool->counts[cls]--;
+		pool->hits++;
+		return h + 1;
+	}
+	pool->misses++;
+	h = (pool_header *)pool->malloc_fn(pool->userdata, sizeof(pool_header) + ((cls < cJSON_POOL_CLASSES) ? ((size_t)16 << cls) : sz));
+	if (!h)
+		return 0;
+	h->cls = cls;
+	return h + 1;
+}
+
+static void pool_free(void *userdata, void *ptr)
+{
+	cJSON_Pool *pool = (cJSON_Pool *)userdata;
+	pool_header *h = (pool_header *)ptr - 1;
+	if (!ptr)
+		return;
+	if (h->cls < cJSON_POOL_CLASSES && pool->counts[h->cls] < pool->cap)
+	{
+		*(void **)ptr = pool->lists[h->cls];
+		pool->lists[h->cls] = h;
+		pool->counts[h->cls]++;
+		return;
+	}
+	pool->free_fn(pool->userdata, h);
+}
+
+void cJSON_InitPool(cJSON_Pool *pool, cJSON_Context *ctx, int cap)
+{
+	memset(pool, 0, sizeof(cJSON_Pool));
+	pool->malloc_fn = ctx->malloc_fn;
+	pool->free_fn = ctx->free_fn;
+	pool->userdata = ctx->userdata;
+	pool->cap = cap;
+	ctx->malloc_fn = pool_malloc;
+	ctx->free_fn = pool_free;
+	ctx->userdata = pool;
+}
+
+void cJSON_TrimPool(cJSON_Pool *pool, int keep)
+{
+	int cls;
+	void *h;
+	for (cls = 0; cls < cJSON_POOL_CLASSES; cls++)
+		while (pool->counts[cls] > keep)
+		{
+			h = pool->lists[cls];
+			pool->lists[cls] = *(void **)((pool_header *)h + 1);
+			pool->counts[cls]--;
+			pool->free_fn(pool->userdata, h);
+		}
+}
+
 /*
 cJSON_strdup ַ
 ֵ=NULL:mallocʧ
@@ -72,18 +172,63 @@ strdup()
 Ҫfree()ͷӦڴռ䣬
 ڴй©
 */
-static char *cJSON_strdup(const char *str)
+static char *cJSON_strdup(const char *str, cJSON_Context *ctx)
 {
 	size_t len;
 	char *copy;
 	//strlen(char *)'\0'ͷ'\0'ǰַ
 	len = strlen(str) + 1;
-	if (!(copy = (char *)cJSON_malloc(len)))
+	if (!(copy = (char *)ctx_malloc(ctx, len)))
 		return 0;
 	memcpy(copy, str, len);
 	return copy;
 }
 
+/* Room for size bytes in item->text that the other inline string (the value when placing the key, and the other way round)
+   does not use, or 0 if there is none. */
+static char *inline_room(cJSON *item, size_t size, int key)
+{
+#if cJSON_INLINE_SIZE > 0
+	const char *other = key ? ((item->type & cJSON_ValueIsInline) ? item->valuestring : 0) : ((item->type & cJSON_StringIsInline) ? item->string : 0);
+	size_t at = 0;
+	if (other)
+	{
+		if (size <= (size_t)(other - item->text))
+			return item->text;
+		at = other - item->text + ((key && (item->type & cJSON_StringIsBinary)) ? (size_t)item->valueint : strlen(other) + 1);
+	}
+	return (at + size <= cJSON_INLINE_SIZE) ? item->text + at : 0;
+#else
+	(void)item, (void)size, (void)key;
+	return 0;
+#endif
+}
+
+/* Copy str to be item's key (key!=0) or value, inline when it fits. The caller has released the old one and cleared its flags. */
+static char *item_strdup(cJSON *item, const char *str, int key, cJSON_Context *ctx)
+{
+	size_t len = strlen(str) + 1;
+	char *copy = inline_room(item, len, key);
+	if (!copy)
+		return cJSON_strdup(str, ctx);
+	item->type |= key ? cJSON_StringIsInline : cJSON_ValueIsInline;
+	memmove(copy, str, len); /* str may be the string this one replaces */
+	return copy;
+}
+
+/* The same for the size bytes of a binary value. */
+static char *item_memdup(cJSON *item, const void *data, int size, cJSON_Context *ctx)
+{
+	char *copy = inline_room(item, size, 0);
+	if (copy)
+		item->type |= cJSON_ValueIsInline;
+	else if (!(copy = (char *)ctx_malloc(ctx, size)))
+		return 0;
+	if (size)
+		memcpy(copy, data, size);
+	return copy;
+}
+
 /*
 cJSON_InitHooks ʼӺ
 :
@@ -104,78 +249,216 @@ void cJSON_InitHooks(cJSON_Hooks *hooks)
 	cJSON_free = (hooks->free_fn) ? hooks->free_fn : free;
 }
 
+/* Nodes and packed element buffers carry the context that allocated them in front. The calls that take no context
+   (cJSON_Delete, adding, replacing, detaching, unpacking) find the allocator a node came from this way, so a tree parsed
+   through a pool can be edited with them, and nodes from different contexts can share one tree. A node's key and string
+   value always come from the node's own context. */
+typedef union
+{
+	cJSON_Context *ctx;
+	int64_t align_i;
+	double align_d;
+} owner_header;
+
+/* A buffer for size bytes of elements, owned by ctx. valuestring points at the elements. */
+static char *packed_alloc(cJSON_Context *ctx, size_t size)
+{
+	owner_header *h = (owner_header *)ctx_malloc(ctx, sizeof(owner_header) + size);
+	if (!h)
+		return 0;
+	h->ctx = ctx;
+	return (char *)(h + 1);
+}
+static cJSON_Context *packed_owner(char *elements) { return ((owner_header *)elements - 1)->ctx; }
+static void packed_free(char *elements)
+{
+	if (elements)
+		ctx_free(packed_owner(elements), (owner_header *)elements - 1);
+}
+
 /* Internal constructor. */
-static cJSON *cJSON_New_Item(void)
+static cJSON *cJSON_New_Item(cJSON_Context *ctx)
 {
-	cJSON *node = (cJSON *)cJSON_malloc(sizeof(cJSON));
-	if (node)//ṹ帳Ϊ0
-		memset(node, 0, sizeof(cJSON));
+	owner_header *h = (owner_header *)ctx_malloc(ctx, sizeof(owner_header) + sizeof(cJSON));
+	cJSON *node;
+	if (!h)
+		return 0;
+	h->ctx = ctx;
+	node = (cJSON *)(h + 1);
+	memset(node, 0, sizeof(cJSON));//ṹ帳Ϊ0
 	return node;
 }
+static cJSON_Context *item_owner(const cJSON *item) { return ((const owner_header *)item - 1)->ctx; }
 //,typeĵھλ͵ڰλʲôô
 //01000000000
 //1<<9 1<<8 1<<7 1<<6 1<<5 1<<4 1<<3 1<<2 1<<1 1<<0
 //512  256  128  64   32   16   8    4    2    1
-/* Delete a cJSON structure. */
-void cJSON_Delete(cJSON *c)
+/* Release the children and the string value of c, a node owned by ctx (c itself may be a copy of it). */
+static void delete_value(cJSON_Context *ctx, cJSON *c)
+{
+	//c->typeṹ
+	if (!(c->type & cJSON_IsReference) && c->child)
+		cJSON_DeleteWithContext(ctx, c->child);
+	if (!(c->type & (cJSON_IsReference | cJSON_ValueIsConst | cJSON_ValueIsInline)) && c->valuestring)
+	{
+		if (c->type & cJSON_IsPacked)
+			packed_free(c->valuestring);
+		else
+			ctx_free(ctx, c->valuestring);
+	}
+}
+
+/* Delete a cJSON structure. Every node goes back to the context that allocated it, whatever ctx is. */
+void cJSON_DeleteWithContext(cJSON_Context *ctx, cJSON *c)
 {
 	cJSON *next;
 	while (c)
 	{
 		next = c->next;
-		//c->typeṹ
-		if (!(c->type & cJSON_IsReference) && c->child)
-			cJSON_Delete(c->child);
-		if (!(c->type & cJSON_IsReference) && c->valuestring)
-			cJSON_free(c->valuestring);
-		if (!(c->type & cJSON_StringIsConst) && c->string)
-			cJSON_free(c->string);
-		cJSON_free(c);
+		ctx = item_owner(c);
+		delete_value(ctx, c);
+		if (!(c->type & (cJSON_StringIsConst | cJSON_StringIsInline)) && c->string)
+			ctx_free(ctx, c->string);
+		ctx_free(ctx, (owner_header *)c - 1);
 		c = next;
 	}
 }
+void cJSON_Delete(cJSON *c) { cJSON_DeleteWithContext(&global_context, c); }
 
-/* Parse the input text to generate a number, and populate the result into item. */
-static const char *parse_number(cJSON *item, const char *num)
+/* The byte at p, or 0 once p reaches end. The scanners read through this so that text with a length ends the way a null
+   terminated string does; end is 0 when the text really is null terminated. */
+static char at(const char *p, const char *end) { return (p != end) ? *p : 0; }
+
+/* Whether the n bytes at p spell word. */
+static int literal(const char *p, const char *end, const char *word, size_t n) { return (!end || (size_t)(end - p) >= n) && !strncmp(p, word, n); }
+
+#ifdef cJSON_NO_FLOAT
+/* Integer-only version: the value truncated toward zero, saturating at the int64_t limits. Digits that do not fit
+   are dropped and made up for by the exponent, so 1e3, 1000.9 and 100000000000000000000e-10 all come out right. */
+static const char *parse_number_value(const char *num, const char *end, cJSON_number *out)
+{
+	uint64_t n = 0, limit = INT64_MAX;
+	int neg = 0, scale = 0, subscale = 0, signsubscale = 1, over = 0;
+
+	if (at(num, end) == '-')
+		neg = 1, limit++, num++;
+	if (at(num, end) == '0')
+		num++;
+	while (at(num, end) >= '0' && *num <= '9')
+	{
+		if (n <= (limit - (*num - '0')) / 10)
+			n = (n * 10) + (*num - '0');
+		else
+			scale++;
+		num++;
+	}
+	if (at(num, end) == '.' && at(num + 1, end) >= '0' && num[1] <= '9')
+	{
+		num++;
+		while (at(num, end) >= '0' && *num <= '9')
+		{
+			if (n <= (limit - (*num - '0')) / 10)
+				n = (n * 10) + (*num - '0'), scale--;
+			num++;
+		}
+	}
+	if (at(num, end) == 'e' || at(num, end) == 'E')
+	{
+		num++;
+		if (at(num, end) == '+')
+			num++;
+		else if (at(num, end) == '-')
+			signsubscale = -1, num++;
+		while (at(num, end) >= '0' && *num <= '9')
+		{
+			if (subscale < 100000)
+				subscale = (subscale * 10) + (*num - '0');
+			num++;
+		}
+	}
+
+	scale += subscale * signsubscale;
+	for (; scale > 0 && n; scale--)
+		if (n > limit / 10)
+		{
+			over = 1;
+			break;
+		}
+		else
+			n *= 10;
+	for (; scale < 0 && n; scale++)
+		n /= 10;
+	if (over)
+		n = limit;
+	*out = (neg && n) ? -(int64_t)(n - 1) - 1 : (int64_t)n;
+	return num;
+}
+#else
+/* Parse the input text to generate a number. */
+static const char *parse_number_value(const char *num, const char *end, cJSON_number *out)
 {
 	double n = 0, sign = 1, scale = 0;
 	//			//
 	int subscale = 0, signsubscale = 1;
 
-	if (*num == '-')
+	if (at(num, end) == '-')
 		sign = -1, num++; /* Has sign? */
-	if (*num == '0')
+	if (at(num, end) == '0')
 		num++; /* is zero */
-	if (*num >= '1' && *num <= '9')
+	if (at(num, end) >= '1' && *num <= '9')
 		do
 			n = (n * 10.0) + (*num++ - '0');
-		while (*num >= '0' && *num <= '9'); /* Number? */
+		while (at(num, end) >= '0' && *num <= '9'); /* Number? */
 	
 	//ⲽ,Խȫȡ
-	if (*num == '.' && num[1] >= '0' && num[1] <= '9')
+	if (at(num, end) == '.' && at(num + 1, end) >= '0' && num[1] <= '9')
 	{
 		num++;
 		do
 			n = (n * 10.0) + (*num++ - '0'), scale--;//scale¼Сλ
-		while (*num >= '0' && *num <= '9');
+		while (at(num, end) >= '0' && *num <= '9');
 	}								/* Fractional part? */
-	if (*num == 'e' || *num == 'E') /* Exponent? */
+	if (at(num, end) == 'e' || at(num, end) == 'E') /* Exponent? */
 	{
 		num++;
-		if (*num == '+')
+		if (at(num, end) == '+')
 			num++;
-		else if (*num == '-')
+		else if (at(num, end) == '-')
 			signsubscale = -1, num++; /* With sign? */
-		while (*num >= '0' && *num <= '9')
+		while (at(num, end) >= '0' && *num <= '9')
 			subscale = (subscale * 10) + (*num++ - '0'); /* Number? */
 	}
 
 	n = sign * n * pow(10.0, (scale + subscale * signsubscale)); /* number = +/- number.fraction * 10^+/- exponent */
 
+	*out = n;
+	return num;
+}
+#endif
+
+/* Parse the input text to generate a number, and populate the result into item. */
+static const char *parse_number(cJSON *item, const char *num, const char *limit, cJSON_Context *ctx)
+{
+	cJSON_number n;
+	const char *end = parse_number_value(num, limit, &n);
 	item->valuedouble = n;
 	item->valueint = (int)n;
 	item->type = cJSON_Number;
-	return num;
+#ifdef cJSON_NO_FLOAT
+	/* Without floating point a decimal is only exact as text, so keep it. */
+	if (memchr(num, '.', end - num) || memchr(num, 'e', end - num) || memchr(num, 'E', end - num))
+	{
+		item->valuestring = (char *)ctx_malloc(ctx, end - num + 1);
+		if (!item->valuestring)
+			return 0;
+		memcpy(item->valuestring, num, end - num);
+		item->valuestring[end - num] = 0;
+		item->type |= cJSON_NumberIsText;
+	}
+#else
+	(void)ctx;
+#endif
+	return end;
 }
 
 
@@ -196,8 +479,24 @@ typedef struct
 	char *buffer;
 	int length;
 	int offset;			//ƫ
+	cJSON_Context *ctx;	/* where the buffer comes from */
+	int flags;			/* cJSON_Ctx* print options */
+	cJSON_WriteFn write_fn;	/* when set, full buffers go out through write_fn(sink,...) instead of growing */
+	void *sink;
+	char *scratch;		/* the caller's buffer, which is never freed */
+	const cJSON_Parallel *par;	/* when set, large containers are printed in pieces on par->run */
 } printbuffer;
 
+/* Hand buffer[0,offset) to the sink and move whatever has been written past offset down to the start. */
+static int flush(printbuffer *p)
+{
+	if (p->offset && p->write_fn(p->sink, p->buffer, p->offset) != p->offset)
+		return 0;
+	memmove(p->buffer, p->buffer + p->offset, p->length - p->offset);
+	p->offset = 0;
+	return 1;
+}
+
 //ʹbufferʱoffset+neededֵlengthʱԽ
 //Խ·һpow2gt()buffer
 //ensureֻǷȫoffset,update
@@ -207,21 +506,34 @@ static char *ensure(printbuffer *p, int needed)
 	int newsize;
 	if (!p || !p->buffer)
 		return 0;
+	if (needed + p->offset > p->length && p->write_fn)
+	{
+		/* Writing to a sink: make room by sending what is done. Only a single item too big for the buffer makes it grow. */
+		if (!flush(p))
+		{
+			if (p->buffer != p->scratch)
+				ctx_free(p->ctx, p->buffer);
+			p->length = 0, p->buffer = 0;
+			return 0;
+		}
+	}
 	needed += p->offset;		//neededԭƫ
 	if (needed <= p->length)	//ԭƫneededСܳ
 		return p->buffer + p->offset;//ûԽ
 
 	newsize = pow2gt(needed);
-	newbuffer = (char *)cJSON_malloc(newsize);
+	newbuffer = (char *)ctx_malloc(p->ctx, newsize);
 	if (!newbuffer)
 	{
-		cJSON_free(p->buffer);
+		if (p->buffer != p->scratch)
+			ctx_free(p->ctx, p->buffer);
 		p->length = 0, p->buffer = 0;
 		return 0;
 	}
 	if (newbuffer)
 		memcpy(newbuffer, p->buffer, p->length);
-	cJSON_free(p->buffer);
+	if (p->buffer != p->scratch)
+		ctx_free(p->ctx, p->buffer);
 	p->length = newsize;
 	p->buffer = newbuffer;
 	return newbuffer + p->offset;
@@ -238,36 +550,39 @@ static int update(printbuffer *p)
 }
 // 1.ΪʲôҪint21ֽ
 // 2.ΪʲôҪdouble64ֽ
-/* Render the number nicely from the given item into a string. */
-static char *print_number(cJSON *item, printbuffer *p)
+#ifdef cJSON_NO_FLOAT
+static char *print_integer(char *out, int64_t v);
+
+/* Integer-only version: all the digits, no floating point. */
+static char *print_double(cJSON_number d, printbuffer *p)
+{
+	char *str = ensure(p, 21); /* -2^63 takes 20 characters */
+	if (str)
+		*print_integer(str, d) = 0;
+	return str;
+}
+#else
+/* Render the number nicely into a string. */
+static char *print_double(cJSON_number d, printbuffer *p)
 {
 	char *str = 0;
-	double d = item->valuedouble;
+	int i = (d <= INT_MAX && d >= INT_MIN) ? (int)d : 0;
 	if (d == 0)
 	{
-		if (p)
-			str = ensure(p, 2);
-		else
-			str = (char *)cJSON_malloc(2); /* special case for 0. */
+		str = ensure(p, 2); /* special case for 0. */
 		if (str)
 			strcpy(str, "0");
 	}
 	//жvaluedoubleǲһ
-	else if (fabs(((double)item->valueint) - d) <= DBL_EPSILON && d <= INT_MAX && d >= INT_MIN)
+	else if (fabs(((double)i) - d) <= DBL_EPSILON && d <= INT_MAX && d >= INT_MIN)
 	{
-		if (p)
-			str = ensure(p, 21);
-		else
-			str = (char *)cJSON_malloc(21); /* 2^64+1 can be represented in 21 chars. */
+		str = ensure(p, 21); /* 2^64+1 can be represented in 21 chars. */
 		if (str)
-			sprintf(str, "%d", item->valueint);
+			sprintf(str, "%d", i);
 	}
 	else
 	{
-		if (p)
-			str = ensure(p, 64);
-		else
-			str = (char *)cJSON_malloc(64); /* This is a nice tradeoff. */
+		str = ensure(p, 64); /* This is a nice tradeoff. */
 		if (str)
 		{
 			//жvaluedoubleֵǷС,жifvaluedoubleĴС,ʹôintֵ뵽
@@ -281,84 +596,73 @@ static char *print_number(cJSON *item, printbuffer *p)
 	}
 	return str;
 }
+#endif
+/* Render the number nicely from the given item into a string. Numbers kept as text print as they were read. */
+static char *print_number(cJSON *item, printbuffer *p)
+{
+	char *str;
+	if (!(item->type & cJSON_NumberIsText) || !item->valuestring)
+		return print_double(item->valuedouble, p);
+	str = ensure(p, strlen(item->valuestring) + 1);
+	if (str)
+		strcpy(str, item->valuestring);
+	return str;
+}
 
 //2ֽڵ(16ת10)
-static unsigned parse_hex4(const char *str)
+static int parse_hex4(const char *str, const char *end, unsigned *out)
 {
 	unsigned h = 0;
-	if (*str >= '0' && *str <= '9')
-		h += (*str) - '0';
-	else if (*str >= 'A' && *str <= 'F')
-		h += 10 + (*str) - 'A';
-	else if (*str >= 'a' && *str <= 'f')
-		h += 10 + (*str) - 'a';
-	else
-		return 0;
-	h = h << 4;
-	str++;
-	if (*str >= '0' && *str <= '9')
-		h += (*str) - '0';
-	else if (*str >= 'A' && *str <= 'F')
-		h += 10 + (*str) - 'A';
-	else if (*str >= 'a' && *str <= 'f')
-		h += 10 + (*str) - 'a';
-	else
-		return 0;
-	h = h << 4;
-	str++;
-	if (*str >= '0' && *str <= '9')
-		h += (*str) - '0';
-	else if (*str >= 'A' && *str <= 'F')
-		h += 10 + (*str) - 'A';
-	else if (*str >= 'a' && *str <= 'f')
-		h += 10 + (*str) - 'a';
-	else
-		return 0;
-	h = h << 4;
-	str++;
-	if (*str >= '0' && *str <= '9')
-		h += (*str) - '0';
-	else if (*str >= 'A' && *str <= 'F')
-		h += 10 + (*str) - 'A';
-	else if (*str >= 'a' && *str <= 'f')
-		h += 10 + (*str) - 'a';
-	else
-		return 0;
-	return h;
+	int i;
+	char c;
+	for (i = 0; i < 4; i++, str++)
+	{
+		c = at(str, end);
+		h = h << 4;
+		if (c >= '0' && c <= '9')
+			h += c - '0';
+		else if (c >= 'A' && c <= 'F')
+			h += 10 + c - 'A';
+		else if (c >= 'a' && c <= 'f')
+			h += 10 + c - 'a';
+		else
+			return 0; /* not four hex digits; stops at the end of the text too */
+	}
+	*out = h;
+	return 1;
 }
 
 /* Parse the input text into an unescaped cstring, and populate item. */
 static const unsigned char firstByteMark[7] = {0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC};
-static const char *parse_string(cJSON *item, const char *str)
+/* How long the unescaped string at str will be, roughly (never less than the real length). */
+static int string_length(const char *str, const char *end)
 {
 	const char *ptr = str + 1;
-	char *ptr2;
-	char *out;
 	int len = 0;
-	unsigned uc, uc2;
-	if (*str != '\"')
-	{
-		ep = str;
-		return 0;
-	} /* not a string! */
-
-	while (*ptr != '\"' && *ptr && ++len)
-		if (*ptr++ == '\\')//
+	char c;
+	while ((c = at(ptr, end)) != '\"' && c && ++len)
+		if (*ptr++ == '\\' && at(ptr, end))//
 			ptr++; /* Skip escaped quotes. ת*/
+	return len;
+}
 
-	out = (char *)cJSON_malloc(len + 1); /* This is how long we need for the string, roughly. */
-	if (!out)
-		return 0;
+/* Unescape the string at str into out, which holds at least string_length(str)+1 bytes. */
+static const char *parse_string_into(const char *str, const char *end, char *out)
+{
+	const char *ptr = str + 1;
+	char *ptr2 = out, c;
+	int len;
+	unsigned uc, uc2;
 
-	ptr = str + 1;
-	ptr2 = out;
-	while (*ptr != '\"' && *ptr)
+	while ((c = at(ptr, end)) != '\"' && c)
 	{
-		if (*ptr != '\\')
+		if (c != '\\')
 			*ptr2++ = *ptr++;
 		else
 		{
 			ptr++;
+			if (!at(ptr, end))
+				break; /* the text ends inside an escape */
 			switch (*ptr)
 			{
 			case 'b':
@@ -377,7 +681,8 @@ static const char *parse_string(cJSON *item, const char *str)
 				*ptr2++ = '\t';//--->/t:ˮƽƱ
 				break;
 			case 'u': /* transcode utf16 to utf8. */
-				uc = parse_hex4(ptr + 1);
+				if (!parse_hex4(ptr + 1, end, &uc))
+					break; /* not a valid escape: drop it and keep what follows */
 				ptr += 4; /* get the unicode char. */
 				//λȶ,һЧ
 				if ((uc >= 0xDC00 && uc <= 0xDFFF) || uc == 0)
@@ -386,9 +691,8 @@ static const char *parse_string(cJSON *item, const char *str)
 				if (uc >= 0xD800 && uc <= 0xDBFF) /* UTF16 surrogate pairs.	*/
 				{
 					//жǷȱٵֽ
-					if (ptr[1] != '\\' || ptr[2] != 'u')
+					if (at(ptr + 1, end) != '\\' || at(ptr + 2, end) != 'u' || !parse_hex4(ptr + 3, end, &uc2))
 						break; /* missing second-half of surrogate.	*/
-					uc2 = parse_hex4(ptr + 3);
 					ptr += 6;
 					//жµõֽǷڵֽڴ
 					if (uc2 < 0xDC00 || uc2 > 0xDFFF)
@@ -431,123 +735,283 @@ static const char *parse_string(cJSON *item, const char *str)
 		}
 	}
 	*ptr2 = 0;
-	if (*ptr == '\"')
+	if (at(ptr, end) == '\"')
 		ptr++;
+	return ptr;
+}
+
+static const char *parse_string(cJSON *item, const char *str, const char *end, cJSON_Context *ctx)
+{
+	char *out;
+	int len, inl = 0;
+	if (at(str, end) != '\"')
+	{
+		ctx->errorptr = str;
+		return 0;
+	} /* not a string! */
+
+	len = string_length(str, end) + 1; /* This is how long we need for the string, roughly. */
+	out = inline_room(item, len, 0);
+	if (out)
+		inl = cJSON_ValueIsInline;
+	else if (!(out = (char *)ctx_malloc(ctx, len)))
+		return 0;
+	str = parse_string_into(str, end, out);
 	item->valuestring = out;
-	item->type = cJSON_String;
+	item->type = cJSON_String | inl;
+	return str;
+}
+
+/* What follows the backslash when a byte below 128 has to be escaped; 0 for bytes that are copied as they are. */
+static const unsigned char escape_table[128] = {
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+	0, 0, '\"', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '\\', 0, 0, 0}; /* the rest are 0 */
+
+/* Eight bytes at a time: a word is clean when none of its bytes is below 32, a quote or a backslash
+   (or, for ASCII output, has the high bit set). Exact as a yes/no answer, which is all we ask of it. */
+#define SWAR_ONES 0x0101010101010101ULL
+#define SWAR_HIGHS 0x8080808080808080ULL
+#define swar_less(x, n) (((x) - SWAR_ONES * (n)) & ~(x) & SWAR_HIGHS)
+#define swar_has(x, c) swar_less((x) ^ (SWAR_ONES * (c)), 1)
+
+/* Return the first byte in [ptr,end) that needs escaping, or end. */
+static const unsigned char *clean_run(const unsigned char *ptr, const unsigned char *end, int ascii)
+{
+	uint64_t w;
+	while (end - ptr >= 8)
+	{
+		memcpy(&w, ptr, 8);
+		if (swar_less(w, 32) | swar_has(w, '\"') | swar_has(w, '\\') | (ascii ? (w & SWAR_HIGHS) : 0))
+			break;
+		ptr += 8;
+	}
+	while (ptr < end && (*ptr < 128 ? !escape_table[*ptr] : !ascii))
+		ptr++;
 	return ptr;
 }
 
-/* Render the cstring provided to an escaped version that can be printed. */
+static char *print_hex4(char *out, unsigned u)
+{
+	static const char hex_digits[] = "0123456789abcdef";
+	*out++ = '\\';
+	*out++ = 'u';
+	*out++ = hex_digits[(u >> 12) & 15];
+	*out++ = hex_digits[(u >> 8) & 15];
+	*out++ = hex_digits[(u >> 4) & 15];
+	*out++ = hex_digits[u & 15];
+	return out;
+}
+
+/* Write the escape for the character at *ptr (at most 12 bytes) and step over it. Bytes of 128 and up only get
+   here for ASCII output: a UTF-8 sequence becomes \uXXXX (a surrogate pair above the BMP), a stray byte \u00XX. */
+static char *print_escape(char *out, const unsigned char **ptr, const unsigned char *end)
+{
+	const unsigned char *c = *ptr;
+	unsigned uc = *c;
+	int n = 1, i;
+	if (uc < 128)
+	{
+		*ptr = c + 1;
+		if (escape_table[uc] == 'u')
+			return print_hex4(out, uc);
+		*out++ = '\\';
+		*out++ = escape_table[uc];
+		return out;
+	}
+	if (uc >= 0xC2 && uc <= 0xDF)
+		n = 2, uc &= 0x1F;
+	else if (uc >= 0xE0 && uc <= 0xEF)
+		n = 3, uc &= 0x0F;
+	else if (uc >= 0xF0 && uc <= 0xF4)
+		n = 4, uc &= 0x07;
+	if (end - c < n)
+		n = 1;
+	for (i = 1; i < n; i++)
+		if ((c[i] & 0xC0) != 0x80)
+			break;
+		else
+			uc = (uc << 6) | (c[i] & 0x3F);
+	if (n == 1 || i < n || (n == 3 && uc < 0x800) || (n == 4 && (uc < 0x10000 || uc > 0x10FFFF)) || (uc >= 0xD800 && uc <= 0xDFFF))
+		n = 1, uc = *c; /* not valid UTF-8: escape the byte itself */
+	*ptr = c + n;
+	if (uc < 0x10000)
+		return print_hex4(out, uc);
+	uc -= 0x10000;
+	out = print_hex4(out, 0xD800 | (uc >> 10));
+	return print_hex4(out, 0xDC00 | (uc & 0x3FF));
+}
+
+/* Render the cstring provided to an escaped version that can be printed.
+   Clean runs are found a word at a time and copied with memcpy; only the rare escapes are written byte by byte. */
 //:print_string_ptrȾһЩǲǺеĵַתʵʵڵ
 static char *print_string_ptr(const char *str, printbuffer *p)
 {
-	const char *ptr;
-	char *ptr2, *out;
-	int len = 0, flag = 0;
-	unsigned char token;
+	const unsigned char *ptr, *end, *run;
+	int len, n, ascii = p->flags & cJSON_CtxPrintAscii;
+	char *out;
 
-	for (ptr = str; *ptr; ptr++)//жַڲûпַ,'\"''\\'
-		flag |= ((*ptr > 0 && *ptr < 32) || (*ptr == '\"') || (*ptr == '\\')) ? 1 : 0;
-	if (!flag)//ַڲڿַ,'\"''\\'if
+	if (!str)
+		str = "";
+	ptr = (const unsigned char *)str;
+	end = ptr + strlen(str);
+	run = clean_run(ptr, end, ascii);
+	if (run == end) /* nothing to escape, which is the usual case */
 	{
-		len = ptr - str;
-		if (p)
-			out = ensure(p, len + 3);//+3Ϊ˿ͷ'\"'β'\"''\0'
-		else
-			out = (char *)cJSON_malloc(len + 3);
+		n = end - ptr;
+		out = ensure(p, n + 3);
 		if (!out)
 			return 0;
-		ptr2 = out;
-		*ptr2++ = '\"';
-		strcpy(ptr2, str);
-		ptr2[len] = '\"';
-		ptr2[len + 1] = 0;
-		return out;//ַ
+		out[0] = '\"';
+		memcpy(out + 1, str, n);
+		out[n + 1] = '\"';
+		out[n + 2] = 0;
+		return out;
 	}
 
-	if (!str)//strΪNULL
+	len = 1;
+	for (;;)
 	{
-		if (p)
-			out = ensure(p, 3);
-		else
-			out = (char *)cJSON_malloc(3);
-		if (!out)//ռʶ
+		n = run - ptr;
+		out = ensure(p, len + n + 14); /* the run, one escape of up to 12 bytes, the closing quote and the terminator */
+		if (!out)
 			return 0;
-		strcpy(out, "\"\"");
-		return out;
+		memcpy(out + len, ptr, n);
+		len += n;
+		if (run == end)
+			break;
+		ptr = run;
+		len = print_escape(out + len, &ptr, end) - out;
+		run = clean_run(ptr, end, ascii);
+	}
+	out[0] = '\"';
+	out[len++] = '\"';
+	out[len] = 0;
+	return out;
+}
+/* Invoke print_string_ptr (which is useful) on an item. */
+/* Base64, standard alphabet, padded. */
+static const char base64_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+/* The value of each digit; 64 for every other byte. */
+static const unsigned char base64_values[256] = {
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 62, 64, 64, 64, 63,
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 64, 64, 64, 64, 64, 64,
+	64, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+	15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 64, 64, 64, 64, 64,
+	64, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+	41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 64, 64, 64, 64, 64,
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,
+	64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64};
+
+/* Write size bytes as base64 at out, unterminated, and return the end. Three bytes make four digits per step. */
+static char *encode_base64(char *out, const unsigned char *in, int size)
+{
+	unsigned long v;
+	for (; size >= 3; size -= 3, in += 3, out += 4)
+	{
+		v = ((unsigned long)in[0] << 16) | ((unsigned long)in[1] << 8) | in[2];
+		out[0] = base64_digits[v >> 18];
+		out[1] = base64_digits[(v >> 12) & 63];
+		out[2] = base64_digits[(v >> 6) & 63];
+		out[3] = base64_digits[v & 63];
 	}
-	ptr = str;
-	//2('\\'+ַ)ͼ6('\\' + uxxxx)ǰʽ
-	while ((token = *ptr) && ++len)
+	if (size)
 	{
-		if (strchr("\"\\\b\f\n\r\t", token))
-			len++;
-		else if (token < 32)
-			len += 5;
-		ptr++;
+		v = ((unsigned long)in[0] << 16) | ((size > 1) ? (unsigned long)in[1] << 8 : 0);
+		out[0] = base64_digits[v >> 18];
+		out[1] = base64_digits[(v >> 12) & 63];
+		out[2] = (size > 1) ? base64_digits[(v >> 6) & 63] : '=';
+		out[3] = '=';
+		out += 4;
 	}
+	return out;
+}
 
-	if (p)
-		out = ensure(p, len + 3);
-	else
-		out = (char *)cJSON_malloc(len + 3);
+/* How many bytes the size digits at in decode to, or -1 if they are not base64. Padding is optional. */
+static int base64_size(const char *in, int size)
+{
+	if (size && in[size - 1] == '=')
+		size -= (size > 1 && in[size - 2] == '=') ? 2 : 1;
+	return (size % 4 == 1) ? -1 : size / 4 * 3 + ((size % 4) ? size % 4 - 1 : 0);
+}
+
+/* Decode the size digits at in into out, and return the byte count or -1 if they are not base64. out may be in itself:
+   every step reads four digits before it writes three bytes. */
+static int decode_base64(unsigned char *out, const char *in, int size)
+{
+	const unsigned char *ptr = (const unsigned char *)in;
+	unsigned char *start = out;
+	unsigned long v;
+	unsigned a, b, c, d;
+	int n = base64_size(in, size);
+	if (n < 0)
+		return -1;
+	for (; n >= 3; n -= 3, ptr += 4, out += 3)
+	{
+		a = base64_values[ptr[0]], b = base64_values[ptr[1]], c = base64_values[ptr[2]], d = base64_values[ptr[3]];
+		if ((a | b | c | d) & 64)
+			return -1; /* one check for all four */
+		v = ((unsigned long)a << 18) | (b << 12) | (c << 6) | d;
+		out[0] = (unsigned char)(v >> 16);
+		out[1] = (unsigned char)(v >> 8);
+		out[2] = (unsigned char)v;
+	}
+	if (n)
+	{
+		a = base64_values[ptr[0]], b = base64_values[ptr[1]], c = (n > 1) ? base64_values[ptr[2]] : 0;
+		if ((a | b | c) & 64)
+			return -1;
+		*out++ = (unsigned char)((a << 2) | (b >> 4));
+		if (n > 1)
+			*out++ = (unsigned char)((b << 4) | (c >> 2));
+	}
+	return (int)(out - start);
+}
+
+/* A binary value, as a base64 string. Into a sink 768 bytes (1024 digits) go at a time, so that its buffer does not have to hold the whole value. */
+static char *print_binary(cJSON *item, printbuffer *p)
+{
+	const unsigned char *in = (const unsigned char *)item->valuestring;
+	int left = item->valueint, step = p->write_fn ? 768 : left;
+	char *out = ensure(p, 1);
 	if (!out)
 		return 0;
-
-	ptr2 = out;
-	ptr = str;
-	*ptr2++ = '\"';
-	while (*ptr)
+	*out = '\"';
+	p->offset++;
+	for (; left > step; left -= step, in += step)
 	{
-		if ((unsigned char)*ptr > 31 && *ptr != '\"' && *ptr != '\\')
-			*ptr2++ = *ptr++;
-		else
-		{
-			*ptr2++ = '\\';
-			switch (token = *ptr++)
-			{
-			case '\\':
-				*ptr2++ = '\\';
-				break;
-			case '\"':
-				*ptr2++ = '\"';
-				break;
-			case '\b':
-				*ptr2++ = 'b';
-				break;
-			case '\f':
-				*ptr2++ = 'f';
-				break;
-			case '\n':
-				*ptr2++ = 'n';
-				break;
-			case '\r':
-				*ptr2++ = 'r';
-				break;
-			case '\t':
-				*ptr2++ = 't';
-				break;
-			default:
-				sprintf(ptr2, "u%04x", token);
-				ptr2 += 5;
-				break; /* escape and print */
-			}
-		}
+		out = ensure(p, step / 3 * 4);
+		if (!out)
+			return 0;
+		p->offset += encode_base64(out, in, step) - out;
 	}
-	*ptr2++ = '\"';
-	*ptr2++ = 0;
-	return out;
+	out = ensure(p, (left + 2) / 3 * 4 + 2);
+	if (!out)
+		return 0;
+	out = encode_base64(out, in, left);
+	*out++ = '\"';
+	*out = 0;
+	return p->buffer + p->offset;
 }
-/* Invoke print_string_ptr (which is useful) on an item. */
-static char *print_string(cJSON *item, printbuffer *p) { return print_string_ptr(item->valuestring, p); }
+static char *print_string(cJSON *item, printbuffer *p) { return (item->type & cJSON_StringIsBinary) ? print_binary(item, p) : print_string_ptr(item->valuestring, p); }
 
 /* Predeclare these prototypes. */
-static const char *parse_value(cJSON *item, const char *value);
+static const char *parse_value(cJSON *item, const char *value, const char *end, cJSON_Context *ctx);
 static char *print_value(cJSON *item, int depth, int fmt, printbuffer *p);
-static const char *parse_array(cJSON *item, const char *value);
+static const char *parse_array(cJSON *item, const char *value, const char *end, cJSON_Context *ctx);
 static char *print_array(cJSON *item, int depth, int fmt, printbuffer *p);
-static const char *parse_object(cJSON *item, const char *value);
+static const char *parse_object(cJSON *item, const char *value, const char *end, cJSON_Context *ctx);
 static char *print_object(cJSON *item, int depth, int fmt, printbuffer *p);
 
 // CRCarriage ReturnӦASCIIתַ\rʾس
@@ -555,38 +1019,38 @@ static char *print_object(cJSON *item, int depth, int fmt, printbuffer *p);
 // CRLFCarriage Return & Linefeed\r\nʾس
 
 /* Utility to jump whitespace and cr/lf */
-static const char *skip(const char *in)
+static const char *skip(const char *in, const char *end)
 {
 	/**/
-	while (in && *in && (unsigned char)*in <= 32)
+	while (in && at(in, end) && (unsigned char)*in <= 32)
 		in++;
 	return in;
 }
 
-/* Parse an object - create a new root, and populate. */
-cJSON *cJSON_ParseWithOpts(const char *value, const char **return_parse_end, int require_null_terminated)
+/* Parse an object - create a new root, and populate. The text runs to limit, or to its null terminator when limit is 0. */
+static cJSON *parse_root(const char *value, const char *limit, const char **return_parse_end, int require_null_terminated, cJSON_Context *ctx)
 {
 	const char *end = 0;
-	cJSON *c = cJSON_New_Item();
-	ep = 0;
+	cJSON *c = cJSON_New_Item(ctx);
+	ctx->errorptr = 0;
 	if (!c)
 		return 0; /* memory fail */
 	//ͨskip(value)valueΪ
-	end = parse_value(c, skip(value));
+	end = parse_value(c, skip(value, limit), limit, ctx);
 	if (!end)
 	{
-		cJSON_Delete(c);
+		cJSON_DeleteWithContext(ctx, c);
 		return 0;
-	} /* parse failure. ep is set. */
+	} /* parse failure. ctx->errorptr is set. */
 
 	/* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
 	if (require_null_terminated)
 	{
-		end = skip(end);
-		if (*end)
+		end = skip(end, limit);
+		if (at(end, limit))
 		{
-			cJSON_Delete(c);
-			ep = end;
+			cJSON_DeleteWithContext(ctx, c);
+			ctx->errorptr = end;
 			return 0;
 		}
 	}
@@ -594,62 +1058,136 @@ cJSON *cJSON_ParseWithOpts(const char *value, const char **return_parse_end, int
 		*return_parse_end = end;
 	return c;
 }
+cJSON *cJSON_ParseWithOpts(const char *value, const char **return_parse_end, int require_null_terminated) { return parse_root(value, 0, return_parse_end, require_null_terminated, &global_context); }
+cJSON *cJSON_ParseWithContext(cJSON_Context *ctx, const char *value, const char **return_parse_end) { return parse_root(value, 0, return_parse_end, ctx->flags & cJSON_CtxRequireNullTerminated, ctx); }
+cJSON *cJSON_ParseWithLengthOpts(const char *value, size_t length, const char **return_parse_end, int require_null_terminated) { return value ? parse_root(value, value + length, return_parse_end, require_null_terminated, &global_context) : 0; }
+cJSON *cJSON_ParseWithLengthWithContext(cJSON_Context *ctx, const char *value, size_t length, const char **return_parse_end) { return value ? parse_root(value, value + length, return_parse_end, ctx->flags & cJSON_CtxRequireNullTerminated, ctx) : 0; }
+cJSON *cJSON_ParseWithLength(const char *value, size_t length) { return cJSON_ParseWithLengthOpts(value, length, 0, 0); }
 /* Default options for cJSON_Parse */
 cJSON *cJSON_Parse(const char *value) { return cJSON_ParseWithOpts(value, 0, 0); }
 
-/* Render a cJSON item/entity/structure to text. */
-char *cJSON_Print(cJSON *item) { return print_value(item, 0, 1, 0); }
-char *cJSON_PrintUnformatted(cJSON *item) { return print_value(item, 0, 0, 0); }
-//ȴһµbufferbuffer
-char *cJSON_PrintBuffered(cJSON *item, int prebuffer, int fmt)
+/* Render a cJSON item/entity/structure to text. Everything goes through a printbuffer, which starts at prebuffer bytes and doubles as needed. */
+static char *print_root(cJSON *item, int prebuffer, int fmt, int flags, cJSON_Context *ctx)
 {
 	printbuffer p;
-	p.buffer = (char *)cJSON_malloc(prebuffer);
+	if (prebuffer <= 0)
+		return 0;
+	p.buffer = (char *)ctx_malloc(ctx, prebuffer);
+	if (!p.buffer)
+		return 0;
 	p.length = prebuffer;
 	p.offset = 0;
-	return print_value(item, 0, fmt, &p);
+	p.ctx = ctx;
+	p.flags = flags;
+	p.write_fn = 0;
+	p.sink = 0;
+	p.scratch = 0;
+	p.par = 0;
+	if (!print_value(item, 0, fmt, &p))
+	{
+		if (p.buffer)
+			ctx_free(ctx, p.buffer);
+		return 0;
+	}
 	return p.buffer;
 }
+char *cJSON_Print(cJSON *item) { return print_root(item, 256, 1, 0, &global_context); }
+char *cJSON_PrintUnformatted(cJSON *item) { return print_root(item, 256, 0, 0, &global_context); }
+char *cJSON_PrintBuffered(cJSON *item, int prebuffer, int fmt) { return print_root(item, prebuffer, fmt, 0, &global_context); }
+char *cJSON_PrintWithContext(cJSON_Context *ctx, cJSON *item, int fmt) { return print_root(item, 256, fmt, ctx->flags, ctx); }
+char *cJSON_PrintCanonical(cJSON *item) { return print_root(item, 256, 0, cJSON_CtxSortKeys, &global_context); }
 
-/* Parser core - when encountering text, process appropriately. */
-static const char *parse_value(cJSON *item, const char *value)
+int cJSON_PrintToSinkWithContext(cJSON_Context *ctx, cJSON *item, int fmt, char *buffer, int size, cJSON_WriteFn write_fn, void *sink)
 {
-	if (!value)
-		return 0; /* Fail on null. */
-	if (!strncmp(value, "null", 4))
+	printbuffer p;
+	int ok;
+	if (!buffer || size < 2)
+		return 0;
+	p.buffer = p.scratch = buffer;
+	p.length = size;
+	p.offset = 0;
+	p.ctx = ctx;
+	p.flags = ctx->flags;
+	p.write_fn = write_fn;
+	p.sink = sink;
+	p.par = 0;
+	ok = print_value(item, 0, fmt, &p) != 0;
+	if (ok)
 	{
-		item->type = cJSON_NULL;
-		return value + 4;
+		p.offset = update(&p);
+		ok = flush(&p);
 	}
-	if (!strncmp(value, "false", 5))
+	if (p.buffer && p.buffer != p.scratch)
+		ctx_free(ctx, p.buffer);
+	return ok;
+}
+char *cJSON_PrintParallelWithContext(cJSON_Context *ctx, cJSON *item, int fmt, const cJSON_Parallel *par)
+{
+	printbuffer p;
+	p.buffer = (char *)ctx_malloc(ctx, 256);
+	if (!p.buffer)
+		return 0;
+	p.length = 256;
+	p.offset = 0;
+	p.ctx = ctx;
+	p.flags = ctx->flags;
+	p.write_fn = 0;
+	p.sink = 0;
+	p.scratch = 0;
+	p.par = (par && par->run && par->jobs > 1) ? par : 0;
+	if (!print_value(item, 0, fmt, &p))
 	{
-		item->type = cJSON_False;
-		return value + 5;
+		if (p.buffer)
+			ctx_free(ctx, p.buffer);
+		return 0;
 	}
-	if (!strncmp(value, "true", 4))
+	return p.buffer;
+}
+char *cJSON_PrintParallel(cJSON *item, int fmt, const cJSON_Parallel *par) { return cJSON_PrintParallelWithContext(&global_context, item, fmt, par); }
+
+int cJSON_PrintToSink(cJSON *item, int fmt, char *buffer, int size, cJSON_WriteFn write_fn, void *sink) { return cJSON_PrintToSinkWithContext(&global_context, item, fmt, buffer, size, write_fn, sink); }
+
+/* Parser core - when encountering text, process appropriately. */
+static const char *parse_value(cJSON *item, const char *value, const char *end, cJSON_Context *ctx)
+{
+	char c;
+	if (!value)
+		return 0; /* Fail on null. */
+	if (literal(value, end, "null", 4))
+	{
+		item->type = cJSON_NULL;
+		return value + 4;
+	}
+	if (literal(value, end, "false", 5))
+	{
+		item->type = cJSON_False;
+		return value + 5;
+	}
+	if (literal(value, end, "true", 4))
 	{
 		item->type = cJSON_True;
 		item->valueint = 1;
 		return value + 4;
 	}
-	if (*value == '\"')
+	c = at(value, end);
+	if (c == '\"')
 	{
-		return parse_string(item, value);
+		return parse_string(item, value, end, ctx);
 	}
-	if (*value == '-' || (*value >= '0' && *value <= '9'))
+	if (c == '-' || (c >= '0' && c <= '9'))
 	{
-		return parse_number(item, value);
+		return parse_number(item, value, end, ctx);
 	}
-	if (*value == '[')
+	if (c == '[')
 	{
-		return parse_array(item, value);
+		return parse_array(item, value, end, ctx);
 	}
-	if (*value == '{')
+	if (c == '{')
 	{
-		return parse_object(item, value);
+		return parse_object(item, value, end, ctx);
 	}
 
-	ep = value;
+	ctx->errorptr = value;
 	return 0; /* failure. */
 }
 
@@ -659,321 +1197,621 @@ static char *print_value(cJSON *item, int depth, int fmt, printbuffer *p)
 	char *out = 0;
 	if (!item)
 		return 0;
-	if (p)
+	switch ((item->type) & 255)
 	{
-		switch ((item->type) & 255)
-		{
-		case cJSON_NULL:
-		{
-			out = ensure(p, 5);
-			if (out)
-				strcpy(out, "null");
+	case cJSON_NULL:
+	{
+		out = ensure(p, 5);
+		if (out)
+			strcpy(out, "null");
+		break;
+	}
+	case cJSON_False:
+	{
+		out = ensure(p, 6);
+		if (out)
+			strcpy(out, "false");
+		break;
+	}
+	case cJSON_True:
+	{
+		out = ensure(p, 5);
+		if (out)
+			strcpy(out, "true");
+		break;
+	}
+	case cJSON_Number:
+		out = print_number(item, p);
+		break;
+	case cJSON_String:
+		out = print_string(item, p);
+		break;
+	case cJSON_Array:
+		out = print_array(item, depth, fmt, p);
+		break;
+	case cJSON_Object:
+		out = print_object(item, depth, fmt, p);
+		break;
+	}
+	return out;
+}
+
+/* Bytes taken by one element of a packed array. */
+static size_t packed_width(cJSON *array) { return (array->type & cJSON_PackedInt32) ? 4 : 8; }
+
+/* Element i of a packed array, as the equivalent number node would hold it. */
+static cJSON_number packed_at(cJSON *array, int i)
+{
+	if (array->type & cJSON_PackedInt32)
+		return ((int32_t *)array->valuestring)[i];
+#ifndef cJSON_NO_FLOAT
+	if (array->type & cJSON_PackedDouble)
+		return ((double *)array->valuestring)[i];
+#endif
+	return (cJSON_number)((int64_t *)array->valuestring)[i];
+}
+
+/* Parse an integer literal exactly: at most 18 digits and no fraction or exponent. Returns 0 for anything else. */
+static const char *parse_integer(const char *num, const char *end, int64_t *out)
+{
+	int64_t n = 0;
+	int neg = 0, digits = 0;
+	char c;
+	if (at(num, end) == '-')
+		neg = 1, num++;
+	while ((c = at(num, end)) >= '0' && c <= '9')
+	{
+		if (++digits > 18)
+			return 0;
+		n = (n * 10) + (c - '0');
+		num++;
+	}
+	if (!digits || c == '.' || c == 'e' || c == 'E')
+		return 0;
+	*out = neg ? -n : n;
+	return num;
+}
+
+/* Try to read the array whose first element is at value as a packed array.
+   Integers are kept exactly as long as they all are integers, and narrowed to int32 when they all fit.
+   Returns 0, with item untouched, when an element is not a number (or memory runs out); the caller then parses it the usual way. */
+static const char *parse_packed_array(cJSON *item, const char *value, const char *limit, cJSON_Context *ctx)
+{
+	union
+	{
+		int64_t i;
+		double d;
+	} *slots = 0, *grown;
+	int count = 0, size = 0, kind = cJSON_PackedInt32, i;
+	const char *end;
+	char *out;
+	int64_t n;
+#ifndef cJSON_NO_FLOAT
+	double d;
+#endif
+
+	for (;;)
+	{
+		if (at(value, limit) != '-' && (at(value, limit) < '0' || *value > '9'))
 			break;
-		}
-		case cJSON_False:
+		if (count == size)
 		{
-			out = ensure(p, 6);
-			if (out)
-				strcpy(out, "false");
-			break;
+			size = size ? size * 2 : 16;
+			grown = ctx_malloc(ctx, size * sizeof(*slots));
+			if (!grown)
+				break;
+			if (slots)
+			{
+				memcpy(grown, slots, count * sizeof(*slots));
+				ctx_free(ctx, slots);
+			}
+			slots = grown;
 		}
-		case cJSON_True:
+		if (kind != cJSON_PackedDouble && (end = parse_integer(value, limit, &n)) != 0)
 		{
-			out = ensure(p, 5);
-			if (out)
-				strcpy(out, "true");
-			break;
+			slots[count].i = n;
+			if (n < INT32_MIN || n > INT32_MAX)
+				kind = cJSON_PackedInt64;
 		}
-		case cJSON_Number:
-			out = print_number(item, p);
-			break;
-		case cJSON_String:
-			out = print_string(item, p);
-			break;
-		case cJSON_Array:
-			out = print_array(item, depth, fmt, p);
-			break;
-		case cJSON_Object:
-			out = print_object(item, depth, fmt, p);
-			break;
+		else
+		{
+#ifdef cJSON_NO_FLOAT
+			break; /* decimals are kept as text, which a packed array has no room for */
+#else
+			end = parse_number_value(value, limit, &d);
+			if (kind != cJSON_PackedDouble)
+				for (i = 0; i < count; i++)
+					slots[i].d = (double)slots[i].i;
+			kind = cJSON_PackedDouble;
+			slots[count].d = d;
+#endif
 		}
-	}
-	else
-	{
-		switch ((item->type) & 255)
+		count++;
+		value = skip(end, limit);
+		if (at(value, limit) == ']')
 		{
-		case cJSON_NULL:
-			out = cJSON_strdup("null");
-			break;
-		case cJSON_False:
-			out = cJSON_strdup("false");
-			break;
-		case cJSON_True:
-			out = cJSON_strdup("true");
-			break;
-		case cJSON_Number:
-			out = print_number(item, 0);
-			break;
-		case cJSON_String:
-			out = print_string(item, 0);
-			break;
-		case cJSON_Array:
-			out = print_array(item, depth, fmt, 0);
-			break;
-		case cJSON_Object:
-			out = print_object(item, depth, fmt, 0);
-			break;
+			/* Copy into a buffer of exactly the right size. */
+			out = packed_alloc(ctx, count * ((kind == cJSON_PackedInt32) ? 4 : 8));
+			if (!out)
+				break;
+			if (kind == cJSON_PackedInt32)
+				for (i = 0; i < count; i++)
+					((int32_t *)out)[i] = (int32_t)slots[i].i;
+			else
+				memcpy(out, slots, count * 8);
+			ctx_free(ctx, slots);
+			item->type = cJSON_Array | kind;
+			item->valuestring = out;
+			item->valueint = count;
+			return value + 1;
 		}
+		if (at(value, limit) != ',')
+			break;
+		value = skip(value + 1, limit);
 	}
-	return out;
+	if (slots)
+		ctx_free(ctx, slots);
+	return 0;
 }
 
 /* Build an array from input text. */
-static const char *parse_array(cJSON *item, const char *value)
+static const char *parse_array(cJSON *item, const char *value, const char *end, cJSON_Context *ctx)
 {
 	cJSON *child;
-	if (*value != '[')
+	const char *last;
+	if (at(value, end) != '[')
 	{
-		ep = value;
+		ctx->errorptr = value;
 		return 0;
 	} /* not an array! */
 
 	item->type = cJSON_Array;
-	value = skip(value + 1);
-	if (*value == ']')
+	value = skip(value + 1, end);
+	if (at(value, end) == ']')
 		return value + 1; /* empty array. */
+	if ((ctx->flags & cJSON_CtxPackNumbers) && (last = parse_packed_array(item, value, end, ctx)) != 0)
+		return last;
 
-	item->child = child = cJSON_New_Item();
+	item->child = child = cJSON_New_Item(ctx);
 	if (!item->child)
-		return 0;								   /* memory fail */
-	value = skip(parse_value(child, skip(value))); /* skip any spacing, get the value. */
+		return 0;										/* memory fail */
+	value = skip(parse_value(child, skip(value, end), end, ctx), end); /* skip any spacing, get the value. */
 	if (!value)
 		return 0;
 
-	while (*value == ',')
+	while (at(value, end) == ',')
 	{
 		cJSON *new_item;
-		if (!(new_item = cJSON_New_Item()))
+		if (!(new_item = cJSON_New_Item(ctx)))
 			return 0; /* memory fail */
 		child->next = new_item;
 		new_item->prev = child;
 		child = new_item;
-		value = skip(parse_value(child, skip(value + 1)));
+		value = skip(parse_value(child, skip(value + 1, end), end, ctx), end);
 		if (!value)
 			return 0; /* memory fail */
 	}
 
-	if (*value == ']')
+	if (at(value, end) == ']')
 		return value + 1; /* end of array */
-	ep = value;
+	ctx->errorptr = value;
 	return 0; /* malformed. */
 }
 
-/* Render an array to text */
-static char *print_array(cJSON *item, int depth, int fmt, printbuffer *p)
+/* Two decimal digits at a time, for print_integer. */
+static const char digit_pairs[] =
+	"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+	"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/* Write v in decimal at out (no terminator) and return the end. Same digits as sprintf("%d") for ints. */
+static char *print_integer(char *out, int64_t v)
 {
-	char **entries;
-	char *out = 0, *ptr, *ret;
-	int len = 5;
-	cJSON *child = item->child;
-	int numentries = 0, i = 0, fail = 0;
-	size_t tmplen = 0;
-	//numentriesͬһжٸ
-	/* How many entries in the array? */
-	while (child)
-		numentries++, child = child->next;
-	/* Explicitly handle numentries==0 */
-	if (!numentries)
-	{
-		if (p)
-			out = ensure(p, 3);
-		else
-			out = (char *)cJSON_malloc(3);
-		if (out)
-			strcpy(out, "[]");
-		return out;
+	char digits[20], *ptr = digits + sizeof(digits);
+	uint64_t u = (v < 0) ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+	while (u >= 100)
+	{
+		ptr -= 2;
+		memcpy(ptr, digit_pairs + (u % 100) * 2, 2);
+		u /= 100;
+	}
+	if (u >= 10)
+	{
+		ptr -= 2;
+		memcpy(ptr, digit_pairs + u * 2, 2);
 	}
+	else
+		*--ptr = (char)('0' + u);
+	if (v < 0)
+		*out++ = '-';
+	memcpy(out, ptr, digits + sizeof(digits) - ptr);
+	return out + (digits + sizeof(digits) - ptr);
+}
 
-	if (p)
+/* Render a packed array with the same text the equivalent array of number nodes would give.
+   Integers are formatted in one pass into a single reservation; doubles go through print_double. */
+static char *print_packed_array(cJSON *item, int fmt, printbuffer *p)
+{
+	int i, j, k, n = item->valueint, sep = fmt ? 2 : 1;
+	char *ptr, *out;
+#ifndef cJSON_NO_FLOAT
+	if (item->type & cJSON_PackedDouble)
 	{
-		/* Compose the output array. */
-		i = p->offset;
-		//ensureֻǷȫoffset,update
-		ptr = ensure(p, 1);
+		ptr = ensure(p, 2);
 		if (!ptr)
 			return 0;
-		*ptr = '[';
+		*ptr++ = '[';
+		*ptr = 0;
 		p->offset++;
-		child = item->child;
-		while (child && !fail)
+		for (i = 0; i < n; i++)
 		{
-			print_value(child, depth + 1, fmt, p);
+			if (!print_double(((double *)item->valuestring)[i], p))
+				return 0;
 			p->offset = update(p);
-			if (child->next)
+			ptr = ensure(p, sep + 1);
+			if (!ptr)
+				return 0;
+			if (i != n - 1)
 			{
-				len = fmt ? 2 : 1;
-				ptr = ensure(p, len + 1);
-				if (!ptr)
-					return 0;
 				*ptr++ = ',';
 				if (fmt)
 					*ptr++ = ' ';
-				*ptr = 0;
-				p->offset += len;
+				p->offset += sep;
 			}
-			child = child->next;
+			*ptr = 0;
 		}
 		ptr = ensure(p, 2);
-		if (!ptr)
-			return 0;
-		*ptr++ = ']';
-		*ptr = 0;
-		out = (p->buffer) + i;
 	}
 	else
+#endif
 	{
-		/* Allocate an array to hold the values for each */
-
-		//ָ,ÿһָ
-		entries = (char **)cJSON_malloc(numentries * sizeof(char *));
-		if (!entries)
+		ptr = ensure(p, 2);
+		if (!ptr)
 			return 0;
-		memset(entries, 0, numentries * sizeof(char *));
-		/* Retrieve all the results: */
-		child = item->child;
-		while (child && !fail)
+		*ptr = '[';
+		p->offset++;
+		/* 64 elements per reservation, so that a sink's buffer does not have to hold the whole array. */
+		for (i = 0; i < n; i += k)
 		{
-			ret = print_value(child, depth + 1, fmt, 0);
-			entries[i++] = ret;
-			if (ret)
-				len += strlen(ret) + 2 + (fmt ? 1 : 0);
-			else
-				fail = 1;
-			child = child->next;
+			k = (n - i < 64) ? n - i : 64;
+			ptr = ensure(p, k * (20 + sep) + 2); /* int64 needs 20 characters at most, sign included */
+			if (!ptr)
+				return 0;
+			for (j = i; j < i + k; j++)
+			{
+				if (item->type & cJSON_PackedInt32)
+					ptr = print_integer(ptr, ((int32_t *)item->valuestring)[j]);
+				else
+					ptr = print_integer(ptr, ((int64_t *)item->valuestring)[j]);
+				if (j != n - 1)
+				{
+					*ptr++ = ',';
+					if (fmt)
+						*ptr++ = ' ';
+				}
+			}
+			p->offset += ptr - (p->buffer + p->offset);
 		}
+		ptr = ensure(p, 2);
+	}
+	if (!ptr)
+		return 0;
+	out = ptr;
+	*ptr++ = ']';
+	*ptr = 0;
+	return out;
+}
 
-		/* If we didn't fail, try to malloc the output string */
-		if (!fail)
-			out = (char *)cJSON_malloc(len);
-		/* If that fails, we fail. */
-		if (!out)
-			fail = 1;
+/* Object members in key order, for cJSON_CtxSortKeys. Members with the same key keep their order. */
+typedef struct
+{
+	cJSON *item;
+	int index;
+} sorted_member;
+
+static int print_elements(cJSON *child, int count, int depth, int fmt, printbuffer *p);
+static int print_members(cJSON *child, sorted_member *sorted, int n, int count, int depth, int fmt, printbuffer *p);
+
+/* One piece of a container printed by print_parallel: count children from child (or from sorted[n]). */
+typedef struct
+{
+	cJSON *child;
+	sorted_member *sorted;
+	int n, count, depth, fmt, object;
+	printbuffer out;
+} print_job;
+
+static void print_job_run(void *arg, int index)
+{
+	print_job *job = (print_job *)arg + index;
+	int ok;
+	job->out.buffer = (char *)ctx_malloc(job->out.ctx, job->out.length);
+	if (!job->out.buffer)
+		return;
+	job->out.buffer[0] = 0;
+	if (job->object)
+		ok = print_members(job->child, job->sorted, job->n, job->count, job->depth, job->fmt, &job->out);
+	else
+		ok = print_elements(job->child, job->count, job->depth, job->fmt, &job->out);
+	if (!ok && job->out.buffer)
+	{
+		ctx_free(job->out.ctx, job->out.buffer);
+		job->out.buffer = 0;
+	}
+}
 
-		/* Handle failure. */
-		if (fail)
+/* Print the children of a large container as p->par->jobs pieces, each into its own buffer on the runner's threads,
+   then copy the pieces into p in order. The pieces print serially inside, so the text is the same as print_elements/print_members.
+   Returns -1 when the container is under the threshold and should be printed serially. */
+static int print_parallel(cJSON *item, sorted_member *sorted, int depth, int fmt, printbuffer *p)
+{
+	const cJSON_Parallel *par = p->par;
+	print_job *jobs;
+	cJSON *c;
+	int n = 0, pieces, i, j, k, len, ok = 1;
+	char *ptr;
+	for (c = item->child; c; c = c->next)
+		n++;
+	if (n < par->threshold || n < 2)
+		return -1;
+	pieces = (par->jobs < n) ? par->jobs : n;
+	jobs = (print_job *)ctx_malloc(p->ctx, pieces * sizeof(print_job));
+	if (!jobs)
+		return 0;
+	for (i = 0, k = 0, c = item->child; i < pieces; i++)
+	{
+		jobs[i].child = sorted ? sorted[k].item : c;
+		jobs[i].sorted = sorted;
+		jobs[i].n = k;
+		jobs[i].count = n / pieces + (i < n % pieces);
+		jobs[i].depth = depth;
+		jobs[i].fmt = fmt;
+		jobs[i].object = (item->type & 255) == cJSON_Object;
+		jobs[i].out.buffer = 0;
+		jobs[i].out.length = 1024;
+		jobs[i].out.offset = 0;
+		jobs[i].out.ctx = p->ctx;
+		jobs[i].out.flags = p->flags;
+		jobs[i].out.write_fn = 0;
+		jobs[i].out.sink = 0;
+		jobs[i].out.scratch = 0;
+		jobs[i].out.par = 0;
+		k += jobs[i].count;
+		if (!sorted)
+			for (j = 0; j < jobs[i].count; j++)
+				c = c->next;
+	}
+	par->run(par->pool, print_job_run, jobs, pieces);
+	for (i = 0; i < pieces; i++)
+	{
+		len = jobs[i].out.offset;
+		ptr = (ok && jobs[i].out.buffer) ? ensure(p, len + 1) : 0;
+		if (ptr)
 		{
-			for (i = 0; i < numentries; i++)
-				if (entries[i])
-					cJSON_free(entries[i]);
-			cJSON_free(entries);
-			return 0;
+			memcpy(ptr, jobs[i].out.buffer, len + 1);
+			p->offset += len;
 		}
+		else
+			ok = 0;
+		if (jobs[i].out.buffer)
+			ctx_free(p->ctx, jobs[i].out.buffer);
+	}
+	ctx_free(p->ctx, jobs);
+	return ok;
+}
 
-		/* Compose the output array. */
-		*out = '[';
-		ptr = out + 1;
-		*ptr = 0;
-		for (i = 0; i < numentries; i++)
+/* Array elements: count of them from child on (-1 for all), each followed by its separator unless it is the last. */
+static int print_elements(cJSON *child, int count, int depth, int fmt, printbuffer *p)
+{
+	char *ptr;
+	int len = fmt ? 2 : 1;
+	for (; child && count--; child = child->next)
+	{
+		print_value(child, depth + 1, fmt, p);
+		p->offset = update(p);
+		if (child->next)
 		{
-			tmplen = strlen(entries[i]);
-			memcpy(ptr, entries[i], tmplen);
-			ptr += tmplen;
-			if (i != numentries - 1)
-			{
-				*ptr++ = ',';
-				if (fmt)
-					*ptr++ = ' ';
-				*ptr = 0;
-			}
-			cJSON_free(entries[i]);
+			ptr = ensure(p, len + 1);
+			if (!ptr)
+				return 0;
+			*ptr++ = ',';
+			if (fmt)
+				*ptr++ = ' ';
+			*ptr = 0;
+			p->offset += len;
 		}
-		cJSON_free(entries);
-		*ptr++ = ']';
-		*ptr++ = 0;
 	}
+	return p->buffer != 0;
+}
+
+/* Render an array to text */
+static char *print_array(cJSON *item, int depth, int fmt, printbuffer *p)
+{
+	char *out = 0, *ptr;
+	int done;
+	cJSON *child = item->child;
+	if ((item->type & cJSON_IsPacked) && item->valueint)
+		return print_packed_array(item, fmt, p);
+	/* Explicitly handle empty arrays */
+	if (!child)
+	{
+		out = ensure(p, 3);
+		if (out)
+			strcpy(out, "[]");
+		return out;
+	}
+
+	/* Compose the output array. */
+	//ensureֻǷȫoffset,update
+	ptr = ensure(p, 1);
+	if (!ptr)
+		return 0;
+	*ptr = '[';
+	p->offset++;
+	done = p->par ? print_parallel(item, 0, depth, fmt, p) : -1;
+	if (done < 0)
+		done = print_elements(child, -1, depth, fmt, p);
+	if (!done)
+		return 0;
+	ptr = ensure(p, 2);
+	if (!ptr)
+		return 0;
+	out = ptr; /* callers only test for 0, and with a sink the start may have gone out already */
+	*ptr++ = ']';
+	*ptr = 0;
 	return out;
 }
 
 /* Build an object from the text. */
-static const char *parse_object(cJSON *item, const char *value)
+static const char *parse_object(cJSON *item, const char *value, const char *end, cJSON_Context *ctx)
 {
 	cJSON *child;
-	if (*value != '{')
+	int key_inline;
+	if (at(value, end) != '{')
 	{
-		ep = value;
+		ctx->errorptr = value;
 		return 0;
 	} /* not an object! */
 
 	item->type = cJSON_Object;
-	value = skip(value + 1);
-	if (*value == '}')
+	value = skip(value + 1, end);
+	if (at(value, end) == '}')
 		return value + 1; /* empty array. */
 
-	item->child = child = cJSON_New_Item();
+	item->child = child = cJSON_New_Item(ctx);
 	if (!item->child)
 		return 0;
-	value = skip(parse_string(child, skip(value)));
+	value = skip(parse_string(child, skip(value, end), end, ctx), end);
 	if (!value)
 		return 0;
 	child->string = child->valuestring;
 	child->valuestring = 0;
-	if (*value != ':')
+	child->type = key_inline = (child->type & cJSON_ValueIsInline) ? cJSON_StringIsInline : 0;
+	if (at(value, end) != ':')
 	{
-		ep = value;
+		ctx->errorptr = value;
 		return 0;
-	}												   /* fail! */
-	value = skip(parse_value(child, skip(value + 1))); /* skip any spacing, get the value. */
+	}														/* fail! */
+	value = parse_value(child, skip(value + 1, end), end, ctx);
+	child->type |= key_inline; /* parsing the value set the type */
+	value = skip(value, end);	   /* skip any spacing, get the value. */
 	if (!value)
 		return 0;
 
-	while (*value == ',')
+	while (at(value, end) == ',')
 	{
 		cJSON *new_item;
-		if (!(new_item = cJSON_New_Item()))
+		if (!(new_item = cJSON_New_Item(ctx)))
 			return 0; /* memory fail */
 		child->next = new_item;
 		new_item->prev = child;
 		child = new_item;
-		value = skip(parse_string(child, skip(value + 1)));
+		value = skip(parse_string(child, skip(value + 1, end), end, ctx), end);
 		if (!value)
 			return 0;
 		child->string = child->valuestring;
 		child->valuestring = 0;
-		if (*value != ':')
+		child->type = key_inline = (child->type & cJSON_ValueIsInline) ? cJSON_StringIsInline : 0;
+		if (at(value, end) != ':')
 		{
-			ep = value;
+			ctx->errorptr = value;
 			return 0;
-		}												   /* fail! */
-		value = skip(parse_value(child, skip(value + 1))); /* skip any spacing, get the value. */
+		}
+		value = parse_value(child, skip(value + 1, end), end, ctx);
+		child->type |= key_inline;
+		value = skip(value, end);
 		if (!value)
 			return 0;
 	}
 
-	if (*value == '}')
+	if (at(value, end) == '}')
 		return value + 1; /* end of array */
-	ep = value;
+	ctx->errorptr = value;
 	return 0; /* malformed. */
 }
 
+static int sorted_member_compare(const void *a, const void *b)
+{
+	const sorted_member *x = (const sorted_member *)a, *y = (const sorted_member *)b;
+	int diff = strcmp(x->item->string ? x->item->string : "", y->item->string ? y->item->string : "");
+	return diff ? diff : x->index - y->index;
+}
+
+static sorted_member *sort_members(cJSON *item, printbuffer *p)
+{
+	sorted_member *members;
+	cJSON *c;
+	int n = 0;
+	for (c = item->child; c; c = c->next)
+		n++;
+	members = (sorted_member *)ctx_malloc(p->ctx, (n + 1) * sizeof(sorted_member));
+	if (!members)
+		return 0;
+	for (n = 0, c = item->child; c; c = c->next, n++)
+		members[n].item = c, members[n].index = n;
+	qsort(members, n, sizeof(sorted_member), sorted_member_compare);
+	members[n].item = 0; /* terminator */
+	return members;
+}
+
+/* Object members: count of them (-1 for all) from child, or from sorted[n] when the keys are sorted. */
+static int print_members(cJSON *child, sorted_member *sorted, int n, int count, int depth, int fmt, printbuffer *p)
+{
+	char *ptr;
+	int len, j;
+	cJSON *next;
+	for (; child && count--; child = next)
+	{
+		next = sorted ? sorted[++n].item : child->next;
+		if (fmt)
+		{
+			ptr = ensure(p, depth);
+			if (!ptr)
+				return 0;
+			for (j = 0; j < depth; j++)
+				*ptr++ = '\t';
+			p->offset += depth;
+		}
+		print_string_ptr(child->string, p);
+		p->offset = update(p);
+
+		len = fmt ? 2 : 1;
+		ptr = ensure(p, len);
+		if (!ptr)
+			return 0;
+		*ptr++ = ':';
+		if (fmt)
+			*ptr++ = '\t';
+		p->offset += len;
+
+		print_value(child, depth, fmt, p);
+		p->offset = update(p);
+
+		len = (fmt ? 1 : 0) + (next ? 1 : 0);
+		ptr = ensure(p, len + 1);
+		if (!ptr)
+			return 0;
+		if (next)
+			*ptr++ = ',';
+		if (fmt)
+			*ptr++ = '\n';
+		*ptr = 0;
+		p->offset += len;
+	}
+	return 1;
+}
+
 /* Render an object to text. */
 static char *print_object(cJSON *item, int depth, int fmt, printbuffer *p)
 {
-	char **entries = 0, **names = 0;
-	char *out = 0, *ptr, *ret, *str;
-	int len = 7, i = 0, j;
+	char *out = 0, *ptr;
+	int len = 7, i = 0, j, done;
 	cJSON *child = item->child;
-	int numentries = 0, fail = 0;
-	size_t tmplen = 0;
-	/* Count the number of entries. */
-	while (child)
-		numentries++, child = child->next;
+	sorted_member *sorted = 0;
 	/* Explicitly handle empty object case */
-	if (!numentries)
+	if (!child)
 	{
-		if (p)
-			out = ensure(p, fmt ? depth + 4 : 3);
-		else
-			out = (char *)cJSON_malloc(fmt ? depth + 4 : 3);
+		out = ensure(p, fmt ? depth + 4 : 3);
 		if (!out)
 			return 0;
 		ptr = out;
@@ -988,165 +1826,51 @@ static char *print_object(cJSON *item, int depth, int fmt, printbuffer *p)
 		*ptr++ = 0;
 		return out;
 	}
-	if (p)
+
+	/* Compose the output: */
+	len = fmt ? 2 : 1;
+	ptr = ensure(p, len + 1);
+	if (!ptr)
+		return 0;
+	*ptr++ = '{';
+	if (fmt)
+		*ptr++ = '\n';
+	*ptr = 0;
+	p->offset += len;
+	depth++;
+	if ((p->flags & cJSON_CtxSortKeys) && child->next)
 	{
-		/* Compose the output: */
-		i = p->offset;
-		len = fmt ? 2 : 1;
-		ptr = ensure(p, len + 1);
-		if (!ptr)
+		sorted = sort_members(item, p);
+		if (!sorted)
 			return 0;
-		*ptr++ = '{';
-		if (fmt)
-			*ptr++ = '\n';
-		*ptr = 0;
-		p->offset += len;
-		child = item->child;
-		depth++;
-		while (child)
-		{
-			if (fmt)
-			{
-				ptr = ensure(p, depth);
-				if (!ptr)
-					return 0;
-				for (j = 0; j < depth; j++)
-					*ptr++ = '\t';
-				p->offset += depth;
-			}
-			print_string_ptr(child->string, p);
-			p->offset = update(p);
-
-			len = fmt ? 2 : 1;
-			ptr = ensure(p, len);
-			if (!ptr)
-				return 0;
-			*ptr++ = ':';
-			if (fmt)
-				*ptr++ = '\t';
-			p->offset += len;
-
-			print_value(child, depth, fmt, p);
-			p->offset = update(p);
-
-			len = (fmt ? 1 : 0) + (child->next ? 1 : 0);
-			ptr = ensure(p, len + 1);
-			if (!ptr)
-				return 0;
-			if (child->next)
-				*ptr++ = ',';
-			if (fmt)
-				*ptr++ = '\n';
-			*ptr = 0;
-			p->offset += len;
-			child = child->next;
-		}
-		ptr = ensure(p, fmt ? (depth + 1) : 2);
-		if (!ptr)
-			return 0;
-		if (fmt)
-			for (i = 0; i < depth - 1; i++)
-				*ptr++ = '\t';
-		*ptr++ = '}';
-		*ptr = 0;
-		out = (p->buffer) + i;
-	}
-	else
-	{
-		/* Allocate space for the names and the objects */
-		entries = (char **)cJSON_malloc(numentries * sizeof(char *));
-		if (!entries)
-			return 0;
-		names = (char **)cJSON_malloc(numentries * sizeof(char *));
-		if (!names)
-		{
-			cJSON_free(entries);
-			return 0;
-		}
-		memset(entries, 0, sizeof(char *) * numentries);
-		memset(names, 0, sizeof(char *) * numentries);
-
-		/* Collect all the results into our arrays: */
-		child = item->child;
-		depth++;
-		if (fmt)
-			len += depth;
-		while (child)
-		{
-			names[i] = str = print_string_ptr(child->string, 0);
-			entries[i++] = ret = print_value(child, depth, fmt, 0);
-			if (str && ret)
-				len += strlen(ret) + strlen(str) + 2 + (fmt ? 2 + depth : 0);
-			else
-				fail = 1;
-			child = child->next;
-		}
-
-		/* Try to allocate the output string */
-		if (!fail)
-			out = (char *)cJSON_malloc(len);
-		if (!out)
-			fail = 1;
-
-		/* Handle failure */
-		if (fail)
-		{
-			for (i = 0; i < numentries; i++)
-			{
-				if (names[i])
-					cJSON_free(names[i]);
-				if (entries[i])
-					cJSON_free(entries[i]);
-			}
-			cJSON_free(names);
-			cJSON_free(entries);
-			return 0;
-		}
-
-		/* Compose the output: */
-		*out = '{';
-		ptr = out + 1;
-		if (fmt)
-			*ptr++ = '\n';
-		*ptr = 0;
-		for (i = 0; i < numentries; i++)
-		{
-			if (fmt)
-				for (j = 0; j < depth; j++)
-					*ptr++ = '\t';
-			tmplen = strlen(names[i]);
-			memcpy(ptr, names[i], tmplen);
-			ptr += tmplen;
-			*ptr++ = ':';
-			if (fmt)
-				*ptr++ = '\t';
-			strcpy(ptr, entries[i]);
-			ptr += strlen(entries[i]);
-			if (i != numentries - 1)
-				*ptr++ = ',';
-			if (fmt)
-				*ptr++ = '\n';
-			*ptr = 0;
-			cJSON_free(names[i]);
-			cJSON_free(entries[i]);
-		}
-
-		cJSON_free(names);
-		cJSON_free(entries);
-		if (fmt)
-			for (i = 0; i < depth - 1; i++)
-				*ptr++ = '\t';
-		*ptr++ = '}';
-		*ptr++ = 0;
-	}
-	return out;
-}
+		child = sorted[0].item;
+	}
+	done = p->par ? print_parallel(item, sorted, depth, fmt, p) : -1;
+	if (done < 0)
+		done = print_members(child, sorted, 0, -1, depth, fmt, p);
+	if (sorted)
+		ctx_free(p->ctx, sorted);
+	if (!done)
+		return 0;
+	ptr = ensure(p, fmt ? (depth + 1) : 2);
+	if (!ptr)
+		return 0;
+	if (fmt)
+		for (j = 0; j < depth - 1; j++)
+			*ptr++ = '\t';
+	out = ptr;
+	*ptr++ = '}';
+	*ptr = 0;
+	return out;
+}
 
 /* Get Array size/item / object item. */
 int cJSON_GetArraySize(cJSON *array)
 {
 	cJSON *c = array->child;
 	int i = 0;
+	if (array->type & cJSON_IsPacked)
+		return array->valueint;
 	while (c)
 		i++, c = c->next;
 	return i;
@@ -1166,6 +1890,52 @@ cJSON *cJSON_GetObjectItem(cJSON *object, const char *string)
 	return c;
 }
 
+/* Lower-cased, so that keys cJSON_strcasecmp calls equal (ASCII case only) hash the same. */
+static unsigned key_hash(const char *str, size_t *length)
+{
+	const char *ptr = str;
+	uint32_t h = cJSON_KEY_HASH_SEED;
+	for (; *ptr; ptr++)
+		h = cJSON_KEY_HASH_STEP(h, *ptr);
+	*length = ptr - str;
+	return h;
+}
+
+void cJSON_CompileKeys(cJSON_Key *keys, int count)
+{
+	int i;
+	for (i = 0; i < count; i++)
+		keys[i].hash = key_hash(keys[i].string, &keys[i].length);
+}
+
+/* A key straight from cJSON_KEY, never compiled: it still matches, by name alone. */
+#define key_compiled(k) ((k)->length || (k)->hash)
+
+int cJSON_GetObjectItems(cJSON *object, const cJSON_Key *keys, int count, cJSON **items)
+{
+	cJSON *c;
+	int i, found = 0, first = 0, last = count;
+	size_t length;
+	unsigned h;
+	for (i = 0; i < count; i++)
+		items[i] = 0;
+	for (c = object->child; c && found < count; c = c->next)
+	{
+		if (!c->string)
+			continue;
+		h = key_hash(c->string, &length);
+		/* Only keys in [first,last) can still be missing; the window shrinks as the ends are found. */
+		for (i = first; i < last; i++)
+			if (!items[i] && (key_compiled(&keys[i]) ? (keys[i].hash == h && keys[i].length == length) : 1) && !cJSON_strcasecmp(keys[i].string, c->string))
+				items[i] = c, found++;
+		while (first < last && items[first])
+			first++;
+		while (last > first && items[last - 1])
+			last--;
+	}
+	return found;
+}
+
 /* Utility for array list handling. */
 static void suffix_object(cJSON *prev, cJSON *item)
 {
@@ -1175,12 +1945,12 @@ static void suffix_object(cJSON *prev, cJSON *item)
 /* Utility for handling references. */
 static cJSON *create_reference(cJSON *item)
 {
-	cJSON *ref = cJSON_New_Item();
+	cJSON *ref = cJSON_New_Item(&global_context);
 	if (!ref)
 		return 0;
 	memcpy(ref, item, sizeof(cJSON));
 	ref->string = 0;
-	ref->type |= cJSON_IsReference;
+	ref->type = (ref->type | cJSON_IsReference) & ~(cJSON_StringIsInline | cJSON_ValueIsInline); /* valuestring still points into item */
 	ref->next = ref->prev = 0;
 	return ref;
 }
@@ -1188,9 +1958,10 @@ static cJSON *create_reference(cJSON *item)
 /* Add item to array/object. */
 void cJSON_AddItemToArray(cJSON *array, cJSON *item)
 {
-	cJSON *c = array->child;
-	if (!item)
+	cJSON *c;
+	if (!item || ((array->type & cJSON_IsPacked) && !cJSON_UnpackArray(array)))
 		return;
+	c = array->child;
 	if (!c)
 	{
 		array->child = item;
@@ -1206,19 +1977,20 @@ void cJSON_AddItemToObject(cJSON *object, const char *string, cJSON *item)
 {
 	if (!item)
 		return;
-	if (item->string)
-		cJSON_free(item->string);
-	item->string = cJSON_strdup(string);
+	if (!(item->type & (cJSON_StringIsConst | cJSON_StringIsInline)) && item->string)
+		ctx_free(item_owner(item), item->string);
+	item->type &= ~(cJSON_StringIsConst | cJSON_StringIsInline);
+	item->string = item_strdup(item, string, 1, item_owner(item));
 	cJSON_AddItemToArray(object, item);
 }
 void cJSON_AddItemToObjectCS(cJSON *object, const char *string, cJSON *item)
 {
 	if (!item)
 		return;
-	if (!(item->type & cJSON_StringIsConst) && item->string)
-		cJSON_free(item->string);
+	if (!(item->type & (cJSON_StringIsConst | cJSON_StringIsInline)) && item->string)
+		ctx_free(item_owner(item), item->string);
 	item->string = (char *)string;
-	item->type |= cJSON_StringIsConst;
+	item->type = (item->type | cJSON_StringIsConst) & ~cJSON_StringIsInline;
 	cJSON_AddItemToArray(object, item);
 }
 void cJSON_AddItemReferenceToArray(cJSON *array, cJSON *item) { cJSON_AddItemToArray(array, create_reference(item)); }
@@ -1226,7 +1998,10 @@ void cJSON_AddItemReferenceToObject(cJSON *object, const char *string, cJSON *it
 
 cJSON *cJSON_DetachItemFromArray(cJSON *array, int which)
 {
-	cJSON *c = array->child;
+	cJSON *c;
+	if ((array->type & cJSON_IsPacked) && !cJSON_UnpackArray(array))
+		return 0;
+	c = array->child;
 	while (c && which > 0)
 		c = c->next, which--;
 	if (!c)
@@ -1256,7 +2031,10 @@ void cJSON_DeleteItemFromObject(cJSON *object, const char *string) { cJSON_Delet
 /* Replace array/object items with new ones. */
 void cJSON_InsertItemInArray(cJSON *array, int which, cJSON *newitem)
 {
-	cJSON *c = array->child;
+	cJSON *c;
+	if ((array->type & cJSON_IsPacked) && !cJSON_UnpackArray(array))
+		return;
+	c = array->child;
 	while (c && which > 0)
 		c = c->next, which--;
 	if (!c)
@@ -1274,7 +2052,10 @@ void cJSON_InsertItemInArray(cJSON *array, int which, cJSON *newitem)
 }
 void cJSON_ReplaceItemInArray(cJSON *array, int which, cJSON *newitem)
 {
-	cJSON *c = array->child;
+	cJSON *c;
+	if ((array->type & cJSON_IsPacked) && !cJSON_UnpackArray(array))
+		return;
+	c = array->child;
 	while (c && which > 0)
 		c = c->next, which--;
 	if (!c)
@@ -1290,6 +2071,34 @@ void cJSON_ReplaceItemInArray(cJSON *array, int which, cJSON *newitem)
 	c->next = c->prev = 0;
 	cJSON_Delete(c);
 }
+void cJSON_ReplaceItemViaPointer(cJSON *parent, cJSON *item, cJSON *replacement)
+{
+	replacement->next = item->next;
+	replacement->prev = item->prev;
+	if (replacement->next)
+		replacement->next->prev = replacement;
+	if (item == parent->child)
+		parent->child = replacement;
+	else
+		replacement->prev->next = replacement;
+	item->next = item->prev = 0;
+
+	/* replacement takes over item's key: the pointer if the key has its own allocation from the same context,
+	   a copy if it lives in item or belongs to another context. */
+	if (!(replacement->type & (cJSON_StringIsConst | cJSON_StringIsInline)) && replacement->string)
+		ctx_free(item_owner(replacement), replacement->string);
+	replacement->type &= ~(cJSON_StringIsConst | cJSON_StringIsInline);
+	replacement->string = 0;
+	if (item->string && ((item->type & cJSON_StringIsInline) || (!(item->type & cJSON_StringIsConst) && item_owner(item) != item_owner(replacement))))
+		replacement->string = item_strdup(replacement, item->string, 1, item_owner(replacement));
+	else
+	{
+		replacement->string = item->string;
+		replacement->type |= item->type & cJSON_StringIsConst;
+		item->string = 0;
+	}
+	cJSON_Delete(item);
+}
 void cJSON_ReplaceItemInObject(cJSON *object, const char *string, cJSON *newitem)
 {
 	int i = 0;
@@ -1298,43 +2107,90 @@ void cJSON_ReplaceItemInObject(cJSON *object, const char *string, cJSON *newitem
 		i++, c = c->next;
 	if (c)
 	{
-		newitem->string = cJSON_strdup(string);
+		if (!(newitem->type & (cJSON_StringIsConst | cJSON_StringIsInline)) && newitem->string)
+			ctx_free(item_owner(newitem), newitem->string);
+		newitem->type &= ~(cJSON_StringIsConst | cJSON_StringIsInline);
+		newitem->string = item_strdup(newitem, string, 1, item_owner(newitem));
 		cJSON_ReplaceItemInArray(object, i, newitem);
 	}
 }
 
+char *cJSON_SetValuestring(cJSON *item, const char *valuestring)
+{
+	char *old, *copy;
+	int type;
+	if (!item || !valuestring || (item->type & (255 | cJSON_IsReference)) != cJSON_String)
+		return 0;
+	old = item->valuestring, type = item->type;
+	item->type &= ~(cJSON_ValueIsConst | cJSON_ValueIsInline | cJSON_StringIsBinary);
+	if (!(copy = item_strdup(item, valuestring, 0, item_owner(item))))
+	{
+		item->type = type;
+		return 0;
+	}
+	if (!(type & (cJSON_ValueIsConst | cJSON_ValueIsInline)) && old)
+		ctx_free(item_owner(item), old);
+	return item->valuestring = copy;
+}
+
+int cJSON_ReplaceValue(cJSON *item, cJSON *value)
+{
+	int key = cJSON_StringIsConst | cJSON_StringIsInline; /* the key stays where it is */
+	/* A string value moves over as is, unless it lives in value or in another context: then item gets a copy of its own. */
+	int copy = value->valuestring && !(value->type & (cJSON_IsReference | cJSON_ValueIsConst | cJSON_IsPacked)) &&
+			   ((value->type & cJSON_ValueIsInline) || item_owner(item) != item_owner(value));
+	cJSON old = *item;
+	item->type = (value->type & ~(key | cJSON_ValueIsInline)) | (old.type & key);
+	item->valuestring = value->valuestring;
+	if (copy && !(item->valuestring = item_memdup(item, value->valuestring, (value->type & cJSON_StringIsBinary) ? value->valueint : (int)strlen(value->valuestring) + 1, item_owner(item))))
+	{
+		item->type = old.type, item->valuestring = old.valuestring;
+		return 0;
+	}
+	item->child = value->child;
+	item->valueint = value->valueint;
+	item->valuedouble = value->valuedouble;
+	delete_value(item_owner(item), &old);
+
+	value->child = 0;
+	if (!copy)
+		value->valuestring = 0;
+	cJSON_Delete(value);
+	return 1;
+}
+
 /* Create basic types: */
 cJSON *cJSON_CreateNull(void)
 {
-	cJSON *item = cJSON_New_Item();
+	cJSON *item = cJSON_New_Item(&global_context);
 	if (item)
 		item->type = cJSON_NULL;
 	return item;
 }
 cJSON *cJSON_CreateTrue(void)
 {
-	cJSON *item = cJSON_New_Item();
+	cJSON *item = cJSON_New_Item(&global_context);
 	if (item)
 		item->type = cJSON_True;
 	return item;
 }
 cJSON *cJSON_CreateFalse(void)
 {
-	cJSON *item = cJSON_New_Item();
+	cJSON *item = cJSON_New_Item(&global_context);
 	if (item)
 		item->type = cJSON_False;
 	return item;
 }
 cJSON *cJSON_CreateBool(int b)
 {
-	cJSON *item = cJSON_New_Item();
+	cJSON *item = cJSON_New_Item(&global_context);
 	if (item)
 		item->type = b ? cJSON_True : cJSON_False;
 	return item;
 }
-cJSON *cJSON_CreateNumber(double num)
+cJSON *cJSON_CreateNumber(cJSON_number num)
 {
-	cJSON *item = cJSON_New_Item();
+	cJSON *item = cJSON_New_Item(&global_context);
 	if (item)
 	{
 		item->type = cJSON_Number;
@@ -1345,24 +2201,34 @@ cJSON *cJSON_CreateNumber(double num)
 }
 cJSON *cJSON_CreateString(const char *string)
 {
-	cJSON *item = cJSON_New_Item();
+	cJSON *item = cJSON_New_Item(&global_context);
 	if (item)
 	{
 		item->type = cJSON_String;
-		item->valuestring = cJSON_strdup(string);
+		item->valuestring = item_strdup(item, string, 0, &global_context);
+	}
+	return item;
+}
+cJSON *cJSON_CreateStringCS(const char *string)
+{
+	cJSON *item = cJSON_New_Item(&global_context);
+	if (item)
+	{
+		item->type = cJSON_String | cJSON_ValueIsConst;
+		item->valuestring = (char *)string;
 	}
 	return item;
 }
 cJSON *cJSON_CreateArray(void)
 {
-	cJSON *item = cJSON_New_Item();
+	cJSON *item = cJSON_New_Item(&global_context);
 	if (item)
 		item->type = cJSON_Array;
 	return item;
 }
 cJSON *cJSON_CreateObject(void)
 {
-	cJSON *item = cJSON_New_Item();
+	cJSON *item = cJSON_New_Item(&global_context);
 	if (item)
 		item->type = cJSON_Object;
 	return item;
@@ -1384,6 +2250,7 @@ cJSON *cJSON_CreateIntArray(const int *numbers, int count)
 	}
 	return a;
 }
+#ifndef cJSON_NO_FLOAT
 cJSON *cJSON_CreateFloatArray(const float *numbers, int count)
 {
 	int i;
@@ -1414,6 +2281,7 @@ cJSON *cJSON_CreateDoubleArray(const double *numbers, int count)
 	}
 	return a;
 }
+#endif
 cJSON *cJSON_CreateStringArray(const char **strings, int count)
 {
 	int i;
@@ -1430,34 +2298,197 @@ cJSON *cJSON_CreateStringArray(const char **strings, int count)
 	return a;
 }
 
+/* Packed arrays */
+static cJSON *create_packed(const void *numbers, int count, int kind, size_t width)
+{
+	cJSON *a = cJSON_New_Item(&global_context);
+	if (!a)
+		return 0;
+	a->type = cJSON_Array | kind;
+	if (count > 0)
+	{
+		a->valuestring = packed_alloc(&global_context, count * width);
+		if (!a->valuestring)
+		{
+			cJSON_Delete(a);
+			return 0;
+		}
+		memcpy(a->valuestring, numbers, count * width);
+		a->valueint = count;
+	}
+	return a;
+}
+cJSON *cJSON_CreatePackedInt32Array(const int32_t *numbers, int count) { return create_packed(numbers, count, cJSON_PackedInt32, sizeof(int32_t)); }
+cJSON *cJSON_CreatePackedInt64Array(const int64_t *numbers, int count) { return create_packed(numbers, count, cJSON_PackedInt64, sizeof(int64_t)); }
+#ifndef cJSON_NO_FLOAT
+cJSON *cJSON_CreatePackedDoubleArray(const double *numbers, int count) { return create_packed(numbers, count, cJSON_PackedDouble, sizeof(double)); }
+#endif
+
+void *cJSON_GetPackedArray(cJSON *array, int *count)
+{
+	if (!array || !(array->type & cJSON_IsPacked))
+		return 0;
+	if (count)
+		*count = array->valueint;
+	return array->valuestring;
+}
+
+int cJSON_UnpackArray(cJSON *array)
+{
+	cJSON *n, *p = 0, *first = 0;
+	cJSON_Context *ctx;
+	int i;
+	if (!(array->type & cJSON_IsPacked))
+		return 1;
+	/* The number nodes come from the context that owns the elements, so the tree keeps one allocator. */
+	ctx = array->valuestring ? packed_owner(array->valuestring) : &global_context;
+	for (i = 0; i < array->valueint; i++)
+	{
+		n = cJSON_New_Item(ctx);
+		if (!n)
+		{
+			cJSON_DeleteWithContext(ctx, first);
+			return 0;
+		}
+		n->type = cJSON_Number;
+		n->valuedouble = packed_at(array, i);
+		n->valueint = (int)n->valuedouble;
+		if (!i)
+			first = n;
+		else
+			suffix_object(p, n);
+		p = n;
+	}
+	if (!(array->type & (cJSON_IsReference | cJSON_ValueIsConst)))
+		packed_free(array->valuestring);
+	array->valuestring = 0;
+	array->valueint = 0;
+	array->type &= ~(cJSON_IsPacked | cJSON_ValueIsConst);
+	array->child = first;
+	return 1;
+}
+
+/* Binary values. */
+cJSON *cJSON_CreateBinary(const void *data, int size)
+{
+	cJSON *item = cJSON_New_Item(&global_context);
+	if (!item)
+		return 0;
+	item->type = cJSON_String | cJSON_StringIsBinary;
+	item->valueint = size;
+	item->valuestring = item_memdup(item, data, size, &global_context);
+	if (!item->valuestring)
+	{
+		cJSON_Delete(item);
+		return 0;
+	}
+	return item;
+}
+
+cJSON *cJSON_CreateBinaryCS(const void *data, int size)
+{
+	cJSON *item = cJSON_New_Item(&global_context);
+	if (item)
+	{
+		item->type = cJSON_String | cJSON_StringIsBinary | cJSON_ValueIsConst;
+		item->valueint = size;
+		item->valuestring = (char *)data;
+	}
+	return item;
+}
+
+void *cJSON_GetBinary(cJSON *item, int *size)
+{
+	int n;
+	if (!item || (item->type & 255) != cJSON_String || !item->valuestring)
+		return 0;
+	if (!(item->type & cJSON_StringIsBinary))
+	{
+		/* Decode where the text is; only a string the item owns can be overwritten. */
+		if (item->type & (cJSON_IsReference | cJSON_ValueIsConst))
+			return 0;
+		n = decode_base64((unsigned char *)item->valuestring, item->valuestring, (int)strlen(item->valuestring));
+		if (n < 0)
+			return 0;
+		item->type |= cJSON_StringIsBinary;
+		item->valueint = n;
+	}
+	if (size)
+		*size = item->valueint;
+	return item->valuestring;
+}
+
+int cJSON_DecodeBinary(cJSON *item, void *buffer, int size)
+{
+	int n, len;
+	if (!item || (item->type & 255) != cJSON_String || !item->valuestring)
+		return -1;
+	if (item->type & cJSON_StringIsBinary)
+	{
+		if (buffer && item->valueint > size)
+			return -1;
+		if (buffer && item->valueint)
+			memcpy(buffer, item->valuestring, item->valueint);
+		return item->valueint;
+	}
+	len = (int)strlen(item->valuestring);
+	n = base64_size(item->valuestring, len);
+	if (n < 0 || !buffer)
+		return n;
+	return (n > size) ? -1 : decode_base64((unsigned char *)buffer, item->valuestring, len);
+}
+
 /* Duplication */
-cJSON *cJSON_Duplicate(cJSON *item, int recurse)
+cJSON *cJSON_DuplicateWithContext(cJSON_Context *ctx, cJSON *item, int recurse)
 {
 	cJSON *newitem, *cptr, *nptr = 0, *newchild;
 	/* Bail on bad ptr */
 	if (!item)
 		return 0;
 	/* Create new item */
-	newitem = cJSON_New_Item();
+	newitem = cJSON_New_Item(ctx);
 	if (!newitem)
 		return 0;
 	/* Copy over all vars */
-	newitem->type = item->type & (~cJSON_IsReference), newitem->valueint = item->valueint, newitem->valuedouble = item->valuedouble;
-	if (item->valuestring)
+	newitem->type = item->type & ~(cJSON_IsReference | cJSON_StringIsInline | cJSON_ValueIsInline), newitem->valueint = item->valueint, newitem->valuedouble = item->valuedouble;
+	if (item->type & cJSON_ValueIsConst)
+		newitem->valuestring = item->valuestring; /* borrowed: the copy borrows it too */
+	else if ((item->type & cJSON_IsPacked) && item->valueint)
 	{
-		newitem->valuestring = cJSON_strdup(item->valuestring);
+		newitem->valuestring = packed_alloc(ctx, item->valueint * packed_width(item));
 		if (!newitem->valuestring)
 		{
-			cJSON_Delete(newitem);
+			cJSON_DeleteWithContext(ctx, newitem);
 			return 0;
 		}
+		memcpy(newitem->valuestring, item->valuestring, item->valueint * packed_width(item));
 	}
-	if (item->string)
+	else if (item->type & cJSON_StringIsBinary)
+	{
+		newitem->valuestring = item_memdup(newitem, item->valuestring, item->valueint, ctx);
+		if (!newitem->valuestring)
+		{
+			cJSON_DeleteWithContext(ctx, newitem);
+			return 0;
+		}
+	}
+	else if (item->valuestring)
+	{
+		newitem->valuestring = item_strdup(newitem, item->valuestring, 0, ctx);
+		if (!newitem->valuestring)
+		{
+			cJSON_DeleteWithContext(ctx, newitem);
+			return 0;
+		}
+	}
+	if (item->type & cJSON_StringIsConst)
+		newitem->string = item->string;
+	else if (item->string)
 	{
-		newitem->string = cJSON_strdup(item->string);
+		newitem->string = item_strdup(newitem, item->string, 1, ctx);
 		if (!newitem->string)
 		{
-			cJSON_Delete(newitem);
+			cJSON_DeleteWithContext(ctx, newitem);
 			return 0;
 		}
 	}
@@ -1468,10 +2499,10 @@ cJSON *cJSON_Duplicate(cJSON *item, int recurse)
 	cptr = item->child;
 	while (cptr)
 	{
-		newchild = cJSON_Duplicate(cptr, 1); /* Duplicate (with recurse) each item in the ->next chain */
+		newchild = cJSON_DuplicateWithContext(ctx, cptr, 1); /* Duplicate (with recurse) each item in the ->next chain */
 		if (!newchild)
 		{
-			cJSON_Delete(newitem);
+			cJSON_DeleteWithContext(ctx, newitem);
 			return 0;
 		}
 		if (nptr)
@@ -1488,42 +2519,1160 @@ cJSON *cJSON_Duplicate(cJSON *item, int recurse)
 	}
 	return newitem;
 }
+cJSON *cJSON_Duplicate(cJSON *item, int recurse) { return cJSON_DuplicateWithContext(&global_context, item, recurse); }
 
-void cJSON_Minify(char *json)
+/* Case sensitive, NULL-safe string equality. */
+static int strings_equal(const char *a, const char *b)
 {
-	char *into = json;
-	while (*json)
+	if (!a || !b)
+		return a == b;
+	return !strcmp(a, b);
+}
+
+/* Find the member of object keyed like want, trying *hint first so members in the same order match straight away. */
+static cJSON *find_member(cJSON *object, cJSON *want, cJSON **hint)
+{
+	cJSON *c;
+	if (*hint && strings_equal((*hint)->string, want->string))
+		c = *hint;
+	else
+		for (c = object->child; c && !strings_equal(c->string, want->string); c = c->next)
+			;
+	*hint = c ? c->next : 0;
+	return c;
+}
+
+/* Every member of a has an equal member in b. Duplicate keys are matched by their first occurrence. */
+static int members_within(cJSON *a, cJSON *b)
+{
+	cJSON *ac, *bc, *hint = b->child;
+	for (ac = a->child; ac; ac = ac->next)
 	{
-		if (*json == ' ')
-			json++;
-		else if (*json == '\t')
-			json++; /* Whitespace characters. */
-		else if (*json == '\r')
-			json++;
-		else if (*json == '\n')
-			json++;
-		else if (*json == '/' && json[1] == '/')
-			while (*json && *json != '\n')
-				json++; /* double-slash comments, to end of line. */
-		else if (*json == '/' && json[1] == '*')
-		{
-			while (*json && !(*json == '*' && json[1] == '/'))
-				json++;
-			json += 2;
-		} /* multiline comments. */
-		else if (*json == '\"')
-		{
-			*into++ = *json++;
-			while (*json && *json != '\"')
-			{
-				if (*json == '\\')
-					*into++ = *json++;
-				*into++ = *json++;
-			}
-			*into++ = *json++;
-		} /* string literals, which are \" sensitive. */
-		else
-			*into++ = *json++; /* All other characters. */
+		bc = find_member(b, ac, &hint);
+		if (!bc || !cJSON_Compare(ac, bc, 1))
+			return 0;
 	}
-	*into = 0; /* and null-terminate. */
+	return 1;
+}
+
+/* A binary value against a binary value or a string, which has to be its base64 text. */
+static int binary_equal(cJSON *a, cJSON *b)
+{
+	char digits[256];
+	const unsigned char *in;
+	const char *text;
+	int left, n, len;
+	cJSON *t;
+	if (!(a->type & cJSON_StringIsBinary))
+		t = a, a = b, b = t;
+	if (b->type & cJSON_StringIsBinary)
+		return a->valueint == b->valueint && (!a->valueint || !memcmp(a->valuestring, b->valuestring, a->valueint));
+	if (!b->valuestring)
+		return 0;
+	in = (const unsigned char *)a->valuestring, text = b->valuestring;
+	for (left = a->valueint; left > 0; left -= n, in += n, text += len)
+	{
+		n = (left < 192) ? left : 192;
+		len = encode_base64(digits, in, n) - digits;
+		if (strncmp(text, digits, len))
+			return 0;
+	}
+	return !*text;
+}
+
+/* A packed array against a packed or ordinary one. Numbers compare as doubles, like number nodes do. */
+static int packed_equal(cJSON *a, cJSON *b)
+{
+	cJSON *c;
+	int i, n;
+	if (!(a->type & cJSON_IsPacked))
+		c = a, a = b, b = c;
+	n = a->valueint;
+	if (b->type & cJSON_IsPacked)
+	{
+		if (b->valueint != n)
+			return 0;
+		for (i = 0; i < n; i++)
+			if (packed_at(a, i) != packed_at(b, i))
+				return 0;
+		return 1;
+	}
+	for (i = 0, c = b->child; i < n && c; i++, c = c->next)
+		if ((c->type & 255) != cJSON_Number || c->valuedouble != packed_at(a, i))
+			return 0;
+	return i == n && !c;
+}
+
+int cJSON_Compare(cJSON *a, cJSON *b, int ignore_order)
+{
+	cJSON *ac, *bc;
+	if (!a || !b)
+		return a == b;
+	if (a == b)
+		return 1;
+	if ((a->type & 255) != (b->type & 255))
+		return 0;
+	switch (a->type & 255)
+	{
+	case cJSON_Number:
+		if ((a->type | b->type) & cJSON_NumberIsText) /* kept as text: compare the text */
+			return ((a->type & b->type) & cJSON_NumberIsText) && strings_equal(a->valuestring, b->valuestring);
+		return a->valuedouble == b->valuedouble;
+	case cJSON_String:
+		if ((a->type | b->type) & cJSON_StringIsBinary)
+			return binary_equal(a, b);
+		return strings_equal(a->valuestring, b->valuestring);
+	case cJSON_Array:
+		if ((a->type | b->type) & cJSON_IsPacked)
+			return packed_equal(a, b);
+		for (ac = a->child, bc = b->child; ac && bc; ac = ac->next, bc = bc->next)
+			if (!cJSON_Compare(ac, bc, ignore_order))
+				return 0;
+		return !ac && !bc;
+	case cJSON_Object:
+		if (ignore_order)
+			return cJSON_GetArraySize(a) == cJSON_GetArraySize(b) && members_within(a, b) && members_within(b, a);
+		for (ac = a->child, bc = b->child; ac && bc; ac = ac->next, bc = bc->next)
+			if (!strings_equal(ac->string, bc->string) || !cJSON_Compare(ac, bc, 0))
+				return 0;
+		return !ac && !bc;
+	default:
+		return 1;
+	}
+}
+
+/* Structural hashing: FNV-1a over the bytes that make up a value, with a final avalanche so that
+   member hashes can be summed (which makes object member order irrelevant). Numbers and type tags
+   are fed in a fixed byte order so the result does not depend on the platform. */
+#define HASH_OFFSET 14695981039346656037ULL
+#define HASH_PRIME 1099511628211ULL
+
+static uint64_t hash_bytes(uint64_t h, const void *data, size_t len)
+{
+	const unsigned char *ptr = (const unsigned char *)data;
+	while (len--)
+		h = (h ^ *ptr++) * HASH_PRIME;
+	return h;
+}
+
+static uint64_t hash_mix(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+#ifdef cJSON_NO_FLOAT
+/* The bits of d as an IEEE 754 double, rounded to nearest even, worked out with integer code so that hashes agree with float builds. */
+static uint64_t number_bits(cJSON_number d)
+{
+	uint64_t u = (d < 0) ? (uint64_t)0 - (uint64_t)d : (uint64_t)d, rest, half;
+	int e = 63, shift;
+	if (!u)
+		return 0;
+	while (!(u >> e))
+		e--;
+	if (e > 52)
+	{
+		shift = e - 52;
+		rest = u & (((uint64_t)1 << shift) - 1);
+		half = (uint64_t)1 << (shift - 1);
+		u >>= shift;
+		if ((rest > half || (rest == half && (u & 1))) && (++u >> 53))
+			u >>= 1, e++;
+	}
+	else
+		u <<= 52 - e;
+	return ((d < 0) ? (uint64_t)1 << 63 : 0) | ((uint64_t)(e + 1023) << 52) | (u & (((uint64_t)1 << 52) - 1));
+}
+#else
+static uint64_t number_bits(cJSON_number d)
+{
+	uint64_t bits = 0;
+	if (d == 0)
+		d = 0; /* -0 and 0 are the same number. */
+	memcpy(&bits, &d, sizeof(d));
+	return bits;
+}
+#endif
+
+/* Feed the number d into h. */
+static uint64_t hash_number(uint64_t h, cJSON_number d)
+{
+	uint64_t bits = number_bits(d);
+	int i;
+	for (i = 0; i < 8; i++, bits >>= 8)
+		h = (h ^ (unsigned char)bits) * HASH_PRIME;
+	return h;
+}
+
+static uint64_t hash_child(void *arg, cJSON *child)
+{
+	(void)arg;
+	return cJSON_Hash(child);
+}
+
+uint64_t cJSON_Hash(cJSON *item)
+{
+	return cJSON_HashWith(item, hash_child, 0);
+}
+
+uint64_t cJSON_HashWith(cJSON *item, uint64_t (*child_hash)(void *arg, cJSON *child), void *arg)
+{
+	uint64_t h, members = 0;
+	unsigned char type, number = cJSON_Number;
+	char digits[256];
+	int i, n;
+	cJSON *c;
+	if (!item)
+		return 0;
+	type = (unsigned char)(item->type & 255);
+	h = hash_bytes(HASH_OFFSET, &type, 1);
+	if (type == cJSON_Number && (item->type & cJSON_NumberIsText) && item->valuestring)
+		h = hash_bytes(h, item->valuestring, strlen(item->valuestring));
+	else if (type == cJSON_Number)
+		h = hash_number(h, item->valuedouble);
+	else if (item->type & cJSON_StringIsBinary) /* as the base64 text it prints as */
+		for (i = 0; i < item->valueint; i += n)
+		{
+			n = (item->valueint - i < 192) ? item->valueint - i : 192;
+			h = hash_bytes(h, digits, encode_base64(digits, (const unsigned char *)item->valuestring + i, n) - digits);
+		}
+	else if (type == cJSON_String && item->valuestring)
+		h = hash_bytes(h, item->valuestring, strlen(item->valuestring));
+	else if (item->type & cJSON_IsPacked) /* as if each element were a number node */
+		for (i = 0; i < item->valueint; i++)
+			h = hash_mix(h ^ hash_number(hash_bytes(HASH_OFFSET, &number, 1), packed_at(item, i)));
+
+	for (c = item->child; c; c = c->next)
+		if (type == cJSON_Object)
+			members += hash_mix(hash_bytes(child_hash(arg, c), c->string, c->string ? strlen(c->string) : 0));
+		else
+			h = hash_mix(h ^ child_hash(arg, c));
+	if (type == cJSON_Object)
+		h = hash_mix(h ^ members);
+	return h;
+}
+
+/* Freezing. The block holds the nodes first, then the object indexes, then the strings. */
+typedef struct
+{
+	cJSON_Frozen *nodes;
+	const cJSON_Frozen **index;
+	char *strings;
+} freezer;
+
+/* Count what item needs: nodes below it, index entries and string bytes. */
+static void freeze_size(cJSON *item, size_t *nodes, size_t *index, size_t *strings)
+{
+	cJSON *c;
+	int count = cJSON_GetArraySize(item);
+	if ((item->type & 255) == cJSON_Array || (item->type & 255) == cJSON_Object)
+		*nodes += count;
+	if ((item->type & 255) == cJSON_Object)
+		*index += count;
+	if (item->string)
+		*strings += strlen(item->string) + 1;
+	if (item->type & cJSON_StringIsBinary)
+		*strings += (item->valueint + 2) / 3 * 4 + 1;
+	else if (((item->type & 255) == cJSON_String || (item->type & cJSON_NumberIsText)) && item->valuestring)
+		*strings += strlen(item->valuestring) + 1;
+	if (!(item->type & cJSON_IsPacked))
+		for (c = item->child; c; c = c->next)
+			freeze_size(c, nodes, index, strings);
+}
+
+static const char *freeze_string(freezer *f, const char *str)
+{
+	char *copy = f->strings;
+	size_t len;
+	if (!str)
+		return 0;
+	len = strlen(str) + 1;
+	memcpy(copy, str, len);
+	f->strings += len;
+	return copy;
+}
+
+/* Members with the same key (case insensitively) keep document order, so a lookup finds the first, as cJSON_GetObjectItem does. */
+static int frozen_key_compare(const void *a, const void *b)
+{
+	const cJSON_Frozen *x = *(const cJSON_Frozen *const *)a, *y = *(const cJSON_Frozen *const *)b;
+	int diff = cJSON_strcasecmp(x->string, y->string);
+	return diff ? diff : (x < y) ? -1 : (x > y);
+}
+
+/* Fill out from item. Its children take the next count nodes, and their own children come after those. */
+static void freeze_item(freezer *f, cJSON *item, cJSON_Frozen *out)
+{
+	cJSON_Frozen *child;
+	cJSON *c;
+	int i;
+	memset(out, 0, sizeof(cJSON_Frozen));
+	out->type = item->type & 255;
+	out->string = freeze_string(f, item->string);
+	out->valueint = item->valueint;
+	out->valuedouble = item->valuedouble;
+	if (item->type & cJSON_StringIsBinary)
+	{
+		out->valuestring = f->strings;
+		f->strings = encode_base64(f->strings, (const unsigned char *)item->valuestring, item->valueint);
+		*f->strings++ = 0;
+	}
+	else if (out->type == cJSON_String || (item->type & cJSON_NumberIsText))
+		out->valuestring = freeze_string(f, item->valuestring);
+	if (out->type != cJSON_Array && out->type != cJSON_Object)
+		return;
+	out->count = cJSON_GetArraySize(item);
+	out->child = child = f->nodes;
+	f->nodes += out->count;
+	if (item->type & cJSON_IsPacked)
+	{
+		out->valueint = 0;
+		for (i = 0; i < out->count; i++)
+		{
+			memset(&child[i], 0, sizeof(cJSON_Frozen));
+			child[i].type = cJSON_Number;
+			child[i].valuedouble = packed_at(item, i);
+			child[i].valueint = (int)child[i].valuedouble;
+		}
+		return;
+	}
+	for (c = item->child, i = 0; c; c = c->next, i++)
+		freeze_item(f, c, &child[i]);
+	if (out->type == cJSON_Object)
+	{
+		out->index = f->index;
+		for (i = 0; i < out->count; i++)
+			f->index[i] = &child[i];
+		qsort(f->index, out->count, sizeof(cJSON_Frozen *), frozen_key_compare);
+		f->index += out->count;
+	}
+}
+
+const cJSON_Frozen *cJSON_FreezeWithContext(cJSON_Context *ctx, cJSON *item)
+{
+	size_t nodes = 1, index = 0, strings = 0;
+	freezer f;
+	cJSON_Frozen *root;
+	freeze_size(item, &nodes, &index, &strings);
+	root = (cJSON_Frozen *)ctx_malloc(ctx, nodes * sizeof(cJSON_Frozen) + index * sizeof(cJSON_Frozen *) + strings);
+	if (!root)
+		return 0;
+	f.nodes = root + 1;
+	f.index = (const cJSON_Frozen **)(root + nodes);
+	f.strings = (char *)(f.index + index);
+	freeze_item(&f, item, root);
+	return root;
+}
+const cJSON_Frozen *cJSON_Freeze(cJSON *item) { return cJSON_FreezeWithContext(&global_context, item); }
+void cJSON_FreeFrozen(const cJSON_Frozen *frozen) { if (frozen) ctx_free(&global_context, (void *)frozen); }
+
+const cJSON_Frozen *cJSON_GetFrozenArrayItem(const cJSON_Frozen *array, int item)
+{
+	return (item >= 0 && item < array->count) ? &array->child[item] : 0;
+}
+
+const cJSON_Frozen *cJSON_GetFrozenObjectItem(const cJSON_Frozen *object, const char *string)
+{
+	int lo = 0, hi = object->count, mid;
+	if (object->type != cJSON_Object)
+		return 0;
+	/* Lower bound, so that the first of several equal keys is found. */
+	while (lo < hi)
+	{
+		mid = lo + (hi - lo) / 2;
+		if (cJSON_strcasecmp(object->index[mid]->string, string) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return (lo < object->count && !cJSON_strcasecmp(object->index[lo]->string, string)) ? object->index[lo] : 0;
+}
+
+/* The slot needs sequentially consistent loads, stores and adds. GCC and clang have builtins for them;
+   elsewhere the slot's members are only volatile, which holds up on a single core. */
+#if defined(__GNUC__)
+#define slot_load(p)		__atomic_load_n(p, __ATOMIC_SEQ_CST)
+#define slot_store(p, v)	__atomic_store_n(p, v, __ATOMIC_SEQ_CST)
+#define slot_add(p, v)		__atomic_add_fetch(p, v, __ATOMIC_SEQ_CST)
+#else
+#define slot_load(p)		(*(p))
+#define slot_store(p, v)	(*(p) = (v))
+#define slot_add(p, v)		(*(p) += (v))
+#endif
+
+void cJSON_InitFrozenSlot(cJSON_FrozenSlot *slot, const cJSON_Frozen *frozen)
+{
+	slot->current = frozen;
+	slot->epoch = 0;
+	slot->readers[0] = slot->readers[1] = 0;
+}
+
+const cJSON_Frozen *cJSON_AcquireFrozen(cJSON_FrozenSlot *slot, int *ticket)
+{
+	unsigned long epoch;
+	for (;;)
+	{
+		epoch = slot_load(&slot->epoch);
+		slot_add(&slot->readers[epoch & 1], 1);
+		/* If a publish moved the epoch on meanwhile, it may not wait for this count: go again. */
+		if (slot_load(&slot->epoch) == epoch)
+			break;
+		slot_add(&slot->readers[epoch & 1], -1);
+	}
+	*ticket = (int)(epoch & 1);
+	return slot_load(&slot->current);
+}
+
+void cJSON_ReleaseFrozen(cJSON_FrozenSlot *slot, int ticket) { slot_add(&slot->readers[ticket], -1); }
+
+const cJSON_Frozen *cJSON_PublishFrozen(cJSON_FrozenSlot *slot, const cJSON_Frozen *frozen)
+{
+	const cJSON_Frozen *old = slot_load(&slot->current);
+	unsigned long epoch = slot_load(&slot->epoch);
+	slot_store(&slot->current, frozen);
+	slot_store(&slot->epoch, epoch + 1);
+	/* Readers from before the swap counted themselves under the old parity. */
+	while (slot_load(&slot->readers[epoch & 1]))
+		;
+	return old;
+}
+
+void cJSON_Minify(char *json)
+{
+	char *into = json;
+	while (*json)
+	{
+		if (*json == ' ')
+			json++;
+		else if (*json == '\t')
+			json++; /* Whitespace characters. */
+		else if (*json == '\r')
+			json++;
+		else if (*json == '\n')
+			json++;
+		else if (*json == '/' && json[1] == '/')
+			while (*json && *json != '\n')
+				json++; /* double-slash comments, to end of line. */
+		else if (*json == '/' && json[1] == '*')
+		{
+			while (*json && !(*json == '*' && json[1] == '/'))
+				json++;
+			json += 2;
+		} /* multiline comments. */
+		else if (*json == '\"')
+		{
+			*into++ = *json++;
+			while (*json && *json != '\"')
+			{
+				if (*json == '\\')
+					*into++ = *json++;
+				*into++ = *json++;
+			}
+			*into++ = *json++;
+		} /* string literals, which are \" sensitive. */
+		else
+			*into++ = *json++; /* All other characters. */
+	}
+	*into = 0; /* and null-terminate. */
+}
+
+/* Struct codec: parse JSON straight into C structs and print C structs straight to JSON, driven by a cJSON_Field table. No cJSON nodes are created. */
+
+/* Utility to jump over a string literal without unescaping it. */
+static const char *skip_string(const char *str, cJSON_Context *ctx)
+{
+	if (*str != '\"')
+	{
+		ctx->errorptr = str;
+		return 0;
+	}
+	str++;
+	while (*str && *str != '\"')
+		if (*str++ == '\\' && *str)
+			str++;
+	if (*str != '\"')
+	{
+		ctx->errorptr = str;
+		return 0;
+	}
+	return str + 1;
+}
+
+/* Utility to jump over any value without building it. */
+static const char *skip_value(const char *value, cJSON_Context *ctx)
+{
+	cJSON_number d;
+	char close;
+	if (!strncmp(value, "null", 4) || !strncmp(value, "true", 4))
+		return value + 4;
+	if (!strncmp(value, "false", 5))
+		return value + 5;
+	if (*value == '\"')
+		return skip_string(value, ctx);
+	if (*value == '-' || (*value >= '0' && *value <= '9'))
+		return parse_number_value(value, 0, &d);
+	if (*value != '[' && *value != '{')
+	{
+		ctx->errorptr = value;
+		return 0;
+	}
+
+	close = (*value == '[') ? ']' : '}';
+	value = skip(value + 1, 0);
+	if (*value == close)
+		return value + 1;
+	for (;;)
+	{
+		if (close == '}')
+		{
+			value = skip(skip_string(value, ctx), 0);
+			if (!value)
+				return 0;
+			if (*value != ':')
+			{
+				ctx->errorptr = value;
+				return 0;
+			}
+			value = skip(value + 1, 0);
+		}
+		value = skip(skip_value(value, ctx), 0);
+		if (!value)
+			return 0;
+		if (*value == close)
+			return value + 1;
+		if (*value != ',')
+		{
+			ctx->errorptr = value;
+			return 0;
+		}
+		value = skip(value + 1, 0);
+	}
+}
+
+/* Find the field for the key literal at name, starting at *hint so that keys arriving in table order match on the first compare. Case insensitive, like cJSON_GetObjectItem. */
+static int find_field(const cJSON_Field *fields, int count, const char *name, int *hint)
+{
+	char key[64];
+	int i, n;
+	if (string_length(name, 0) >= (int)sizeof(key))
+		return -1; /* longer than any sane key; treat as unknown */
+	parse_string_into(name, 0, key);
+	for (n = 0, i = *hint; n < count; n++, i = (i + 1 < count) ? i + 1 : 0)
+		if (!cJSON_strcasecmp(fields[i].key, key))
+		{
+			*hint = (i + 1 < count) ? i + 1 : 0;
+			return i;
+		}
+	return -1;
+}
+
+static const char *parse_struct_object(const char *value, const cJSON_Field *fields, int count, char *base, cJSON_Context *ctx);
+static const char *parse_struct_field(const char *value, const cJSON_Field *field, char *base, cJSON_Context *ctx);
+
+static const char *parse_struct_array(const char *value, const cJSON_Field *field, char *base, cJSON_Context *ctx)
+{
+	const cJSON_Field *element = field->fields;
+	int n = 0;
+	if (*value != '[')
+	{
+		ctx->errorptr = value;
+		return 0;
+	}
+	value = skip(value + 1, 0);
+	if (*value != ']')
+		for (;;)
+		{
+			if (n >= field->count)
+			{
+				ctx->errorptr = value;
+				return 0;
+			} /* more items than the member can hold */
+			value = skip(parse_struct_field(value, element, base + field->offset + n * element->size, ctx), 0);
+			if (!value)
+				return 0;
+			n++;
+			if (*value == ']')
+				break;
+			if (*value != ',')
+			{
+				ctx->errorptr = value;
+				return 0;
+			}
+			value = skip(value + 1, 0);
+		}
+	*(int *)(base + field->count_offset) = n;
+	return value + 1;
+}
+
+/* Parse one value into the member described by field. A null leaves the member untouched. */
+static const char *parse_struct_field(const char *value, const cJSON_Field *field, char *base, cJSON_Context *ctx)
+{
+	char *dst = base + field->offset, *out;
+	const char *name;
+	cJSON_number d;
+	if (!strncmp(value, "null", 4))
+		return value + 4;
+	switch (field->type)
+	{
+	case cJSON_FieldInt:
+#ifndef cJSON_NO_FLOAT
+	case cJSON_FieldDouble:
+	case cJSON_FieldFloat:
+#endif
+		if (*value != '-' && (*value < '0' || *value > '9'))
+			break;
+		name = parse_number_value(value, 0, &d);
+		/* Like cJSON_Reflect's fits<T>: a number the member cannot hold fails instead of being cast out of range. */
+		if (field->type == cJSON_FieldInt)
+		{
+			if (d < INT_MIN || d > INT_MAX || d != (int)d)
+				break;
+			*(int *)dst = (int)d;
+		}
+#ifndef cJSON_NO_FLOAT
+		else if (field->type == cJSON_FieldDouble)
+			*(double *)dst = d;
+		else
+		{
+			if (d < -FLT_MAX || d > FLT_MAX)
+				break;
+			*(float *)dst = (float)d;
+		}
+#endif
+		return name;
+	case cJSON_FieldBool:
+		if (!strncmp(value, "true", 4))
+		{
+			*(int *)dst = 1;
+			return value + 4;
+		}
+		if (!strncmp(value, "false", 5))
+		{
+			*(int *)dst = 0;
+			return value + 5;
+		}
+		break;
+	case cJSON_FieldString:
+		if (*value != '\"')
+			break;
+		out = (char *)ctx_malloc(ctx, string_length(value, 0) + 1);
+		if (!out)
+			return 0;
+		if (*(char **)dst) /* a repeated key: the last value wins, so release the earlier one */
+			ctx_free(ctx, *(char **)dst);
+		*(char **)dst = out;
+		return parse_string_into(value, 0, out);
+	case cJSON_FieldChars:
+		if (*value != '\"')
+			break;
+		if ((size_t)string_length(value, 0) < field->size)
+			return parse_string_into(value, 0, dst);
+		/* The rough length counts escapes at their escaped size; decode aside to see if it really fits. */
+		out = (char *)ctx_malloc(ctx, string_length(value, 0) + 1);
+		if (!out)
+			return 0;
+		name = parse_string_into(value, 0, out);
+		if (strlen(out) < field->size)
+			strcpy(dst, out);
+		else
+			name = 0;
+		ctx_free(ctx, out);
+		if (name)
+			return name;
+		break; /* does not fit */
+	case cJSON_FieldObject:
+		return parse_struct_object(value, field->fields, field->count, dst, ctx);
+	case cJSON_FieldArray:
+		return parse_struct_array(value, field, base, ctx);
+	}
+	ctx->errorptr = value;
+	return 0;
+}
+
+static const char *parse_struct_object(const char *value, const cJSON_Field *fields, int count, char *base, cJSON_Context *ctx)
+{
+	const char *name;
+	int i, hint = 0;
+	if (*value != '{')
+	{
+		ctx->errorptr = value;
+		return 0;
+	}
+	value = skip(value + 1, 0);
+	if (*value == '}')
+		return value + 1;
+	for (;;)
+	{
+		name = value;
+		value = skip(skip_string(value, ctx), 0);
+		if (!value)
+			return 0;
+		if (*value != ':')
+		{
+			ctx->errorptr = value;
+			return 0;
+		}
+		value = skip(value + 1, 0);
+		i = find_field(fields, count, name, &hint);
+		value = skip((i >= 0) ? parse_struct_field(value, &fields[i], base, ctx) : skip_value(value, ctx), 0); /* unknown keys are skipped */
+		if (!value)
+			return 0;
+		if (*value == '}')
+			return value + 1;
+		if (*value != ',')
+		{
+			ctx->errorptr = value;
+			return 0;
+		}
+		value = skip(value + 1, 0);
+	}
+}
+
+int cJSON_ParseStructWithContext(cJSON_Context *ctx, const char *value, const cJSON_Field *fields, int count, void *out)
+{
+	ctx->errorptr = 0;
+	if (!value)
+		return 0;
+	return parse_struct_object(skip(value, 0), fields, count, (char *)out, ctx) != 0;
+}
+int cJSON_ParseStruct(const char *value, const cJSON_Field *fields, int count, void *out) { return cJSON_ParseStructWithContext(&global_context, value, fields, count, out); }
+
+static int print_struct_object(const char *base, const cJSON_Field *fields, int count, int depth, int fmt, printbuffer *p);
+static int print_struct_field(const char *base, const cJSON_Field *field, int depth, int fmt, printbuffer *p);
+
+static int print_struct_array(const char *base, const cJSON_Field *field, int depth, int fmt, printbuffer *p)
+{
+	int i, n = *(const int *)(base + field->count_offset);
+	char *ptr;
+	if (n > field->count)
+		n = field->count;
+	ptr = ensure(p, 3);
+	if (!ptr)
+		return 0;
+	*ptr = '[';
+	p->offset++;
+	for (i = 0; i < n; i++)
+	{
+		if (!print_struct_field(base + field->offset + i * field->fields->size, field->fields, depth + 1, fmt, p))
+			return 0;
+		p->offset = update(p);
+		if (i != n - 1)
+		{
+			ptr = ensure(p, fmt ? 3 : 2);
+			if (!ptr)
+				return 0;
+			*ptr++ = ',';
+			if (fmt)
+				*ptr++ = ' ';
+			*ptr = 0;
+			p->offset += fmt ? 2 : 1;
+		}
+	}
+	ptr = ensure(p, 2);
+	if (!ptr)
+		return 0;
+	*ptr++ = ']';
+	*ptr = 0;
+	return 1;
+}
+
+/* Render the member described by field at p->offset, the same way print_value would render the equivalent node. */
+static int print_struct_field(const char *base, const cJSON_Field *field, int depth, int fmt, printbuffer *p)
+{
+	const char *src = base + field->offset;
+	char *out;
+	switch (field->type)
+	{
+	case cJSON_FieldInt:
+		return print_double(*(const int *)src, p) != 0;
+#ifndef cJSON_NO_FLOAT
+	case cJSON_FieldDouble:
+		return print_double(*(const double *)src, p) != 0;
+	case cJSON_FieldFloat:
+		return print_double(*(const float *)src, p) != 0;
+#endif
+	case cJSON_FieldBool:
+		out = ensure(p, 6);
+		if (out)
+			strcpy(out, *(const int *)src ? "true" : "false");
+		return out != 0;
+	case cJSON_FieldString:
+		if (!*(char *const *)src)
+		{
+			out = ensure(p, 5);
+			if (out)
+				strcpy(out, "null");
+			return out != 0;
+		}
+		return print_string_ptr(*(char *const *)src, p) != 0;
+	case cJSON_FieldChars:
+		return print_string_ptr(src, p) != 0;
+	case cJSON_FieldObject:
+		return print_struct_object(src, field->fields, field->count, depth, fmt, p);
+	case cJSON_FieldArray:
+		return print_struct_array(base, field, depth, fmt, p);
+	}
+	return 0;
+}
+
+static int print_struct_object(const char *base, const cJSON_Field *fields, int count, int depth, int fmt, printbuffer *p)
+{
+	char *ptr;
+	int i, j;
+	if (!count)
+	{
+		ptr = ensure(p, fmt ? depth + 4 : 3);
+		if (!ptr)
+			return 0;
+		*ptr++ = '{';
+		if (fmt)
+		{
+			*ptr++ = '\n';
+			for (i = 0; i < depth - 1; i++)
+				*ptr++ = '\t';
+		}
+		*ptr++ = '}';
+		*ptr = 0;
+		return 1;
+	}
+
+	ptr = ensure(p, 3);
+	if (!ptr)
+		return 0;
+	*ptr++ = '{';
+	if (fmt)
+		*ptr++ = '\n';
+	*ptr = 0;
+	p->offset += fmt ? 2 : 1;
+	depth++;
+	for (i = 0; i < count; i++)
+	{
+		if (fmt)
+		{
+			ptr = ensure(p, depth);
+			if (!ptr)
+				return 0;
+			for (j = 0; j < depth; j++)
+				*ptr++ = '\t';
+			p->offset += depth;
+		}
+		if (!print_string_ptr(fields[i].key, p))
+			return 0;
+		p->offset = update(p);
+
+		ptr = ensure(p, 2);
+		if (!ptr)
+			return 0;
+		*ptr++ = ':';
+		if (fmt)
+			*ptr++ = '\t';
+		p->offset += fmt ? 2 : 1;
+
+		if (!print_struct_field(base, &fields[i], depth, fmt, p))
+			return 0;
+		p->offset = update(p);
+
+		ptr = ensure(p, 3);
+		if (!ptr)
+			return 0;
+		if (i != count - 1)
+			*ptr++ = ',', p->offset++;
+		if (fmt)
+			*ptr++ = '\n', p->offset++;
+		*ptr = 0;
+	}
+	ptr = ensure(p, fmt ? (depth + 1) : 2);
+	if (!ptr)
+		return 0;
+	if (fmt)
+		for (i = 0; i < depth - 1; i++)
+			*ptr++ = '\t';
+	*ptr++ = '}';
+	*ptr = 0;
+	return 1;
+}
+
+char *cJSON_PrintStructWithContext(cJSON_Context *ctx, const void *in, const cJSON_Field *fields, int count, int fmt)
+{
+	printbuffer p;
+	p.buffer = (char *)ctx_malloc(ctx, 256);
+	p.length = 256;
+	p.offset = 0;
+	p.ctx = ctx;
+	p.flags = 0;
+	p.write_fn = 0;
+	p.sink = 0;
+	p.scratch = 0;
+	p.par = 0;
+	if (!p.buffer)
+		return 0;
+	if (!print_struct_object((const char *)in, fields, count, 0, fmt, &p))
+	{
+		if (p.buffer)
+			ctx_free(ctx, p.buffer);
+		return 0;
+	}
+	return p.buffer;
+}
+char *cJSON_PrintStruct(const void *in, const cJSON_Field *fields, int count, int fmt) { return cJSON_PrintStructWithContext(&global_context, in, fields, count, fmt); }
+
+static void free_struct_field(char *base, const cJSON_Field *field, cJSON_Context *ctx)
+{
+	int i, n;
+	switch (field->type)
+	{
+	case cJSON_FieldString:
+		if (*(char **)(base + field->offset))
+			ctx_free(ctx, *(char **)(base + field->offset));
+		*(char **)(base + field->offset) = 0;
+		break;
+	case cJSON_FieldObject:
+		cJSON_FreeStructWithContext(ctx, base + field->offset, field->fields, field->count);
+		break;
+	case cJSON_FieldArray:
+		n = *(int *)(base + field->count_offset);
+		for (i = 0; i < n && i < field->count; i++)
+			free_struct_field(base + field->offset + i * field->fields->size, field->fields, ctx);
+		break;
+	}
+}
+
+void cJSON_FreeStructWithContext(cJSON_Context *ctx, void *in, const cJSON_Field *fields, int count)
+{
+	int i;
+	for (i = 0; i < count; i++)
+		free_struct_field((char *)in, &fields[i], ctx);
+}
+void cJSON_FreeStruct(void *in, const cJSON_Field *fields, int count) { cJSON_FreeStructWithContext(&global_context, in, fields, count); }
+
+/* NDJSON stream. Arena blocks start with this header; records are carved out of the newest block. */
+typedef union
+{
+	struct { void *next; size_t size; } link;
+	void *align_p;
+	double align_d;
+} arena_block;
+
+static void *arena_malloc(void *userdata, size_t sz)
+{
+	cJSON_Stream *s = (cJSON_Stream *)userdata;
+	arena_block *b;
+	size_t size;
+	void *ptr;
+	sz = (sz + sizeof(arena_block) - 1) / sizeof(arena_block) * sizeof(arena_block);
+	if (!s->top || (size_t)(s->limit - s->top) < sz)
+	{
+		size = s->blocks ? ((arena_block *)s->blocks)->link.size * 2 : 4096;
+		if (size < sz)
+			size = sz;
+		b = (arena_block *)ctx_malloc(s->parent, sizeof(arena_block) + size);
+		if (!b)
+			return 0;
+		b->link.next = s->blocks;
+		b->link.size = size;
+		s->blocks = b;
+		s->top = (char *)(b + 1);
+		s->limit = s->top + size;
+	}
+	ptr = s->top;
+	s->top += sz;
+	return ptr;
+}
+
+/* Everything goes at once, when the arena is reset. */
+static void arena_free(void *userdata, void *ptr) { (void)userdata; (void)ptr; }
+
+/* Rewind the arena. If the last record needed more than one block, swap them for one block as big as all of them together,
+   so that records of that size fit from now on without going back to the allocator. */
+static void arena_reset(cJSON_Stream *s)
+{
+	arena_block *b = (arena_block *)s->blocks, *next;
+	size_t size = 0;
+	if (b && b->link.next)
+	{
+		for (; b; b = next)
+		{
+			next = (arena_block *)b->link.next;
+			size += b->link.size;
+			ctx_free(s->parent, b);
+		}
+		b = (arena_block *)ctx_malloc(s->parent, sizeof(arena_block) + size);
+		if (b)
+		{
+			b->link.next = 0;
+			b->link.size = size;
+		}
+		s->blocks = b;
+	}
+	s->top = b ? (char *)(b + 1) : 0;
+	s->limit = b ? s->top + b->link.size : 0;
+}
+
+int cJSON_InitStream(cJSON_Stream *s, cJSON_Context *ctx, cJSON_ReadFn read_fn, void *source)
+{
+	memset(s, 0, sizeof(cJSON_Stream));
+	s->read_fn = read_fn;
+	s->source = source;
+	s->parent = ctx ? ctx : &global_context;
+	s->ctx.malloc_fn = arena_malloc;
+	s->ctx.free_fn = arena_free;
+	s->ctx.userdata = s;
+	s->ctx.flags = s->parent->flags;
+	s->size = 4096;
+	s->buffer = (char *)ctx_malloc(s->parent, s->size);
+	return s->buffer != 0;
+}
+
+void cJSON_FreeStream(cJSON_Stream *s)
+{
+	void *b, *next;
+	for (b = s->blocks; b; b = next)
+	{
+		next = ((arena_block *)b)->link.next;
+		ctx_free(s->parent, b);
+	}
+	if (s->buffer)
+		ctx_free(s->parent, s->buffer);
+	s->blocks = s->buffer = 0;
+	s->top = s->limit = 0;
+}
+
+/* Make room for at least one more byte after end, keeping one spare for the terminator. */
+static int stream_room(cJSON_Stream *s)
+{
+	char *bigger;
+	if (s->start)
+	{
+		memmove(s->buffer, s->buffer + s->start, s->end - s->start);
+		s->scanned -= s->start;
+		s->end -= s->start;
+		s->start = 0;
+	}
+	if (s->end + 1 < s->size)
+		return 1;
+	bigger = (char *)ctx_malloc(s->parent, s->size * 2);
+	if (!bigger)
+		return 0;
+	memcpy(bigger, s->buffer, s->end);
+	ctx_free(s->parent, s->buffer);
+	s->buffer = bigger;
+	s->size *= 2;
+	return 1;
+}
+
+int cJSON_StreamNext(cJSON_Stream *s, cJSON **record)
+{
+	char *nl, *line;
+	int n;
+	*record = 0;
+	arena_reset(s);
+	for (;;)
+	{
+		/* Only the bytes that arrived since the last look are searched for the newline. */
+		while (!(nl = (char *)memchr(s->buffer + s->scanned, '\n', s->end - s->scanned)))
+		{
+			s->scanned = s->end;
+			if (s->eof)
+			{
+				if (s->start == s->end)
+					return 0;
+				nl = s->buffer + s->end;	/* last line, without a newline */
+				break;
+			}
+			if (!stream_room(s))
+				return -2;
+			n = s->read_fn(s->source, s->buffer + s->end, (int)(s->size - 1 - s->end));
+			if (n < 0)
+				return -2;
+			if (!n)
+				s->eof = 1;
+			s->end += n;
+		}
+		*nl = 0;
+		line = s->buffer + s->start;
+		s->line++;
+		s->start = s->scanned = (nl < s->buffer + s->end) ? (size_t)(nl - s->buffer) + 1 : s->end;
+		if (*skip(line, 0))
+			break;
+	}
+	*record = parse_root(line, 0, 0, 1, &s->ctx);
+	return *record ? 1 : -1;
+}
+
+int cJSON_ReadFile(void *file, char *buffer, int size)
+{
+	size_t n = fread(buffer, 1, size, (FILE *)file);
+	return n ? (int)n : ferror((FILE *)file) ? -1 : 0;
+}
+
+int cJSON_WriteFile(void *file, const char *data, int size) { return (int)fwrite(data, 1, size, (FILE *)file); }
+
+/* Text primitives. The formatters run the printer on the caller's buffer, which is sized so that ensure() never has to grow it. */
+const char *cJSON_SkipWhitespace(const char *in) { return skip(in, 0); }
+
+const char *cJSON_SkipValue(const char *value)
+{
+	cJSON_Context ctx;
+	cJSON_InitContext(&ctx);
+	return skip_value(value, &ctx);
+}
+
+const char *cJSON_ScanNumber(const char *num, cJSON_number *out) { return parse_number_value(num, 0, out); }
+const char *cJSON_ScanInteger(const char *num, int64_t *out) { return parse_integer(num, 0, out); }
+int cJSON_ScanStringSize(const char *str) { return string_length(str, 0) + 1; }
+const char *cJSON_ScanString(const char *str, char *out) { return (*str == '\"') ? parse_string_into(str, 0, out) : 0; }
+
+char *cJSON_FormatNumber(char *out, cJSON_number d)
+{
+	printbuffer p = {0, cJSON_NUMBER_SPACE, 0, &global_context, 0, 0, 0, 0, 0};
+	p.buffer = out;
+	print_double(d, &p);
+	return out + strlen(out);
+}
+
+char *cJSON_FormatInteger(char *out, int64_t v)
+{
+	out = print_integer(out, v);
+	*out = 0;
+	return out;
+}
+
+char *cJSON_FormatString(char *out, const char *str)
+{
+	printbuffer p = {0, 0, 0, &global_context, 0, 0, 0, 0, 0};
+	p.buffer = out;
+	p.length = cJSON_STRING_SPACE(strlen(str));
+	print_string_ptr(str, &p);
+	return out + strlen(out);
+}
+
+char *cJSON_FormatBinary(char *out, const void *data, int size)
+{
+	*out++ = '\"';
+	out = encode_base64(out, (const unsigned char *)data, size);
+	*out++ = '\"';
+	*out = 0;
+	return out;
+}
+
+const char *cJSON_ScanBinary(const char *str, void *out, int size, int *count)
+{
+	const char *end = str + 1;
+	int n;
+	if (*str != '\"')
+		return 0;
+	while (base64_values[(unsigned char)*end] < 64 || *end == '=')
+		end++;
+	if (*end != '\"')
+		return 0; /* not base64, or escaped */
+	n = base64_size(str + 1, (int)(end - str - 1));
+	if (n < 0 || n > size || decode_base64((unsigned char *)out, str + 1, (int)(end - str - 1)) < 0)
+		return 0;
+	*count = n;
+	return end + 1;
 }
@@ -0,0 +1,1530 @@
+/*
+  Copyright (c) 2009 Dave Gamble
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* cJSON_Utils */
+/* JSON Pointer, JSON Patch, JSON Merge Patch and JSON Schema validation on top of cJSON. */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include "cJSON_Utils.h"
+
+/* Structural hashing.
+   Every node of a tree is hashed once, bottom up, into a side table laid out in pre-order.
+   The children of table[i] start at i+1 and each child is followed by its own subtree, so
+   table[i].size lets a walk jump over a whole branch. Two branches with different hashes
+   differ, which is what makes diffing a large, mostly unchanged tree cheap; equal hashes are
+   confirmed with cJSON_Compare (see same_node) so a collision can never drop a change.
+   The hashes come from cJSON_HashWith, so table[i].hash == cJSON_Hash(table[i].item). */
+typedef struct
+{
+	cJSON *item;
+	uint64_t hash;
+	size_t size; /* nodes in this subtree, the node itself included */
+} utils_node;
+
+static size_t count_nodes(cJSON *item)
+{
+	size_t n = 1;
+	cJSON *c;
+	for (c = item->child; c; c = c->next)
+		n += count_nodes(c);
+	return n;
+}
+
+typedef struct
+{
+	utils_node *table;
+	size_t next; /* the next free slot */
+} table_fill;
+
+/* Give item the next slot, then let cJSON_HashWith visit its children, which fill the slots after it. */
+static uint64_t fill_table(void *arg, cJSON *item)
+{
+	table_fill *f = (table_fill *)arg;
+	size_t at = f->next++;
+	f->table[at].item = item;
+	f->table[at].hash = cJSON_HashWith(item, fill_table, f);
+	f->table[at].size = f->next - at;
+	return f->table[at].hash;
+}
+
+static utils_node *build_table(cJSON *item)
+{
+	utils_node *table = (utils_node *)malloc(count_nodes(item) * sizeof(utils_node));
+	table_fill f;
+	f.table = table;
+	f.next = 0;
+	if (table)
+		fill_table(&f, item);
+	return table;
+}
+
+/* Equal hashes are only a hint: confirm with a full compare before a branch is skipped. */
+static int same_node(const utils_node *a, size_t ai, const utils_node *b, size_t bi)
+{
+	return a[ai].hash == b[bi].hash && cJSON_Compare(a[ai].item, b[bi].item, 1);
+}
+
+/* Case sensitive key compare; cJSON_GetObjectItem is case insensitive, JSON Pointer is not. */
+static int key_compare(const char *a, const char *b)
+{
+	if (!a || !b)
+		return (a == b) ? 0 : (a ? 1 : -1);
+	return strcmp(a, b);
+}
+
+/* Object members in table order, sorted by key so two objects can be merge-walked. */
+typedef struct
+{
+	const char *key;
+	size_t index;
+} utils_member;
+
+static int member_compare(const void *a, const void *b)
+{
+	return key_compare(((const utils_member *)a)->key, ((const utils_member *)b)->key);
+}
+
+/* Collect the table indices of the children of table[at]. Returns the count, or -1 on memory failure. */
+static int collect_children(utils_node *table, size_t at, size_t **out)
+{
+	size_t i, n = 0, *list;
+	for (i = at + 1; i < at + table[at].size; i += table[i].size)
+		n++;
+	*out = 0;
+	if (!n)
+		return 0;
+	list = (size_t *)malloc(n * sizeof(size_t));
+	if (!list)
+		return -1;
+	n = 0;
+	for (i = at + 1; i < at + table[at].size; i += table[i].size)
+		list[n++] = i;
+	*out = list;
+	return (int)n;
+}
+
+static int collect_members(utils_node *table, size_t at, utils_member **out)
+{
+	size_t i, *children;
+	int n = collect_children(table, at, &children);
+	utils_member *members;
+	*out = 0;
+	if (n <= 0)
+		return n;
+	members = (utils_member *)malloc(n * sizeof(utils_member));
+	if (!members)
+	{
+		free(children);
+		return -1;
+	}
+	for (i = 0; i < (size_t)n; i++)
+	{
+		members[i].key = table[children[i]].item->string;
+		members[i].index = children[i];
+	}
+	free(children);
+	qsort(members, n, sizeof(utils_member), member_compare);
+	*out = members;
+	return n;
+}
+
+/* JSON Pointer. */
+
+/* Compare one encoded reference token (ending at '/' or end) against a key, decoding ~0 and ~1 on the fly. */
+static int token_equals(const char *token, const char *end, const char *key)
+{
+	if (!key)
+		return 0;
+	while (token < end && *token != '/' && *key)
+	{
+		if (*token == '~')
+		{
+			if (token + 1 >= end || (token[1] != '0' && token[1] != '1'))
+				return 0;
+			if (*key != (token[1] == '0' ? '~' : '/'))
+				return 0;
+			token += 2;
+		}
+		else if (*token++ != *key)
+			return 0;
+		key++;
+	}
+	return (token >= end || *token == '/') && !*key;
+}
+
+/* Parse an array index token. Leading zeros are not allowed. Returns -1 when the token is not an index. */
+static int token_index(const char *token, const char *end)
+{
+	int n = 0;
+	if (token >= end || *token == '/')
+		return -1;
+	if (*token == '0' && token + 1 < end && token[1] != '/')
+		return -1;
+	while (token < end && *token != '/')
+	{
+		if (*token < '0' || *token > '9' || n > (INT_MAX - 9) / 10)
+			return -1;
+		n = n * 10 + (*token++ - '0');
+	}
+	return n;
+}
+
+static cJSON *object_item(cJSON *object, const char *token, const char *end)
+{
+	cJSON *c = object->child;
+	while (c && !token_equals(token, end, c->string))
+		c = c->next;
+	return c;
+}
+
+static cJSON *array_item(cJSON *array, int which)
+{
+	cJSON *c = array->child;
+	while (c && which > 0)
+		which--, c = c->next;
+	return c;
+}
+
+/* Resolve pointer[0..end) against object. */
+static cJSON *resolve_pointer(cJSON *object, const char *pointer, const char *end)
+{
+	while (object && pointer < end)
+	{
+		if (*pointer++ != '/')
+			return 0;
+		if ((object->type & 255) == cJSON_Array)
+		{
+			int which = token_index(pointer, end);
+			object = (which < 0) ? 0 : array_item(object, which);
+		}
+		else if ((object->type & 255) == cJSON_Object)
+			object = object_item(object, pointer, end);
+		else
+			return 0;
+		while (pointer < end && *pointer != '/')
+			pointer++;
+	}
+	return object;
+}
+
+cJSON *cJSONUtils_GetPointer(cJSON *object, const char *pointer)
+{
+	if (!object || !pointer)
+		return 0;
+	return resolve_pointer(object, pointer, pointer + strlen(pointer));
+}
+
+/* Decode the reference token [token..end) into a freshly allocated key. */
+static char *token_decode(const char *token, const char *end)
+{
+	char *key = (char *)malloc(end - token + 1), *out = key;
+	if (!key)
+		return 0;
+	while (token < end)
+	{
+		if (*token == '~' && token + 1 < end && (token[1] == '0' || token[1] == '1'))
+		{
+			*out++ = (token[1] == '0') ? '~' : '/';
+			token += 2;
+		}
+		else
+			*out++ = *token++;
+	}
+	*out = 0;
+	return key;
+}
+
+/* Tree surgery that keeps the rest of the list untouched. */
+static void detach_item(cJSON *parent, cJSON *c)
+{
+	if (c->prev)
+		c->prev->next = c->next;
+	if (c->next)
+		c->next->prev = c->prev;
+	if (c == parent->child)
+		parent->child = c->next;
+	c->prev = c->next = 0;
+}
+
+/* JSON Patch generation. */
+
+typedef struct
+{
+	cJSON *patches;
+	utils_node *from, *to;
+	char *path;
+	size_t length, size;
+	int fail;
+} utils_diff;
+
+/* Append "/segment" to the current path, escaping '~' and '/'. Returns the previous length for path_pop. */
+static size_t path_push(utils_diff *d, const char *segment)
+{
+	size_t old = d->length, need = d->length + 2 + 2 * strlen(segment);
+	if (need > d->size)
+	{
+		char *grown = (char *)realloc(d->path, need * 2);
+		if (!grown)
+		{
+			d->fail = 1;
+			return old;
+		}
+		d->path = grown;
+		d->size = need * 2;
+	}
+	d->path[d->length++] = '/';
+	for (; *segment; segment++)
+	{
+		if (*segment == '~' || *segment == '/')
+		{
+			d->path[d->length++] = '~';
+			d->path[d->length++] = (*segment == '~') ? '0' : '1';
+		}
+		else
+			d->path[d->length++] = *segment;
+	}
+	d->path[d->length] = 0;
+	return old;
+}
+
+static size_t path_push_index(utils_diff *d, size_t index)
+{
+	char buf[24];
+	sprintf(buf, "%lu", (unsigned long)index);
+	return path_push(d, buf);
+}
+
+static void path_pop(utils_diff *d, size_t length)
+{
+	d->length = length;
+	if (d->path)
+		d->path[length] = 0;
+}
+
+void cJSONUtils_AddPatchToArray(cJSON *array, const char *op, const char *path, cJSON *value)
+{
+	cJSON *patch = cJSON_CreateObject();
+	if (!patch)
+		return;
+	cJSON_AddItemToObject(patch, "op", cJSON_CreateString(op));
+	cJSON_AddItemToObject(patch, "path", cJSON_CreateString(path));
+	if (value)
+		cJSON_AddItemToObject(patch, "value", cJSON_Duplicate(value, 1));
+	cJSON_AddItemToArray(array, patch);
+}
+
+static void diff_emit(utils_diff *d, const char *op, cJSON *value)
+{
+	if (!d->fail)
+		cJSONUtils_AddPatchToArray(d->patches, op, d->path ? d->path : "", value);
+}
+
+static void diff_nodes(utils_diff *d, size_t fi, size_t ti);
+
+static void diff_arrays(utils_diff *d, size_t fi, size_t ti)
+{
+	size_t *fc, *tc, n, m, prefix = 0, suffix = 0, common, i, mark;
+	int fn = collect_children(d->from, fi, &fc), tn = collect_children(d->to, ti, &tc);
+	if (fn < 0 || tn < 0)
+	{
+		free(fc), free(tc);
+		d->fail = 1;
+		return;
+	}
+	n = fn, m = tn;
+
+	/* Trim the unchanged head and tail so an insert or delete in the middle is a single op. */
+	while (prefix < n && prefix < m && same_node(d->from, fc[prefix], d->to, tc[prefix]))
+		prefix++;
+	while (suffix < n - prefix && suffix < m - prefix && same_node(d->from, fc[n - 1 - suffix], d->to, tc[m - 1 - suffix]))
+		suffix++;
+	n -= prefix + suffix;
+	m -= prefix + suffix;
+	common = (n < m) ? n : m;
+
+	for (i = 0; i < common && !d->fail; i++)
+	{
+		mark = path_push_index(d, prefix + i);
+		diff_nodes(d, fc[prefix + i], tc[prefix + i]);
+		path_pop(d, mark);
+	}
+	/* Remove from the back so the indices of the remaining items stay valid. */
+	for (i = n; i > common && !d->fail; i--)
+	{
+		mark = path_push_index(d, prefix + i - 1);
+		diff_emit(d, "remove", 0);
+		path_pop(d, mark);
+	}
+	for (i = common; i < m && !d->fail; i++)
+	{
+		mark = path_push_index(d, prefix + i);
+		diff_emit(d, "add", d->to[tc[prefix + i]].item);
+		path_pop(d, mark);
+	}
+	free(fc);
+	free(tc);
+}
+
+static void diff_objects(utils_diff *d, size_t fi, size_t ti)
+{
+	utils_member *fm, *tm;
+	int fn = collect_members(d->from, fi, &fm), tn = collect_members(d->to, ti, &tm), i = 0, j = 0, c;
+	size_t mark;
+	if (fn < 0 || tn < 0)
+	{
+		free(fm), free(tm);
+		d->fail = 1;
+		return;
+	}
+	while ((i < fn || j < tn) && !d->fail)
+	{
+		if (i >= fn)
+			c = 1;
+		else if (j >= tn)
+			c = -1;
+		else
+			c = key_compare(fm[i].key, tm[j].key);
+
+		mark = path_push(d, (c > 0) ? tm[j].key : fm[i].key);
+		if (c < 0)
+			diff_emit(d, "remove", 0), i++;
+		else if (c > 0)
+			diff_emit(d, "add", d->to[tm[j].index].item), j++;
+		else
+			diff_nodes(d, fm[i++].index, tm[j++].index);
+		path_pop(d, mark);
+	}
+	free(fm);
+	free(tm);
+}
+
+static void diff_nodes(utils_diff *d, size_t fi, size_t ti)
+{
+	int ftype = d->from[fi].item->type & 255, ttype = d->to[ti].item->type & 255;
+	if (same_node(d->from, fi, d->to, ti))
+		return; /* Equal subtree, nothing to send. */
+	if (ftype != ttype || (ftype != cJSON_Array && ftype != cJSON_Object) || ((d->from[fi].item->type | d->to[ti].item->type) & cJSON_IsPacked))
+		diff_emit(d, "replace", d->to[ti].item); /* packed arrays are sent whole */
+	else if (ftype == cJSON_Array)
+		diff_arrays(d, fi, ti);
+	else
+		diff_objects(d, fi, ti);
+}
+
+cJSON *cJSONUtils_GeneratePatches(cJSON *from, cJSON *to)
+{
+	utils_diff d;
+	if (!from || !to)
+		return 0;
+	memset(&d, 0, sizeof(d));
+	d.patches = cJSON_CreateArray();
+	d.from = build_table(from);
+	d.to = build_table(to);
+	if (!d.patches || !d.from || !d.to)
+		d.fail = 1;
+	else
+		diff_nodes(&d, 0, 0);
+	free(d.from);
+	free(d.to);
+	free(d.path);
+	if (d.fail)
+	{
+		cJSON_Delete(d.patches);
+		return 0;
+	}
+	return d.patches;
+}
+
+/* JSON Patch application. */
+
+/* Insert value at pointer, as "add" does. value is consumed on success. */
+static int patch_add(cJSON *object, const char *path, cJSON *value)
+{
+	const char *end = path + strlen(path), *last = strrchr(path, '/');
+	cJSON *parent, *old;
+	char *key;
+	int which;
+
+	if (!*path) /* the whole document: replace it in place so callers holding the pointer see the new value */
+		return cJSON_ReplaceValue(object, value) ? 0 : 5;
+	if (!last)
+		return 1;
+	parent = resolve_pointer(object, path, last++);
+	if (!parent)
+		return 2;
+	if ((parent->type & 255) == cJSON_Array)
+	{
+		if (last + 1 == end && *last == '-')
+		{
+			cJSON_AddItemToArray(parent, value);
+			return 0;
+		}
+		which = token_index(last, end);
+		if (which < 0 || which > cJSON_GetArraySize(parent))
+			return 3;
+		cJSON_InsertItemInArray(parent, which, value);
+		return 0;
+	}
+	if ((parent->type & 255) != cJSON_Object)
+		return 4;
+	old = object_item(parent, last, end);
+	if (old)
+	{
+		cJSON_ReplaceItemViaPointer(parent, old, value);
+		return 0;
+	}
+	key = token_decode(last, end);
+	if (!key)
+		return 5;
+	cJSON_AddItemToObject(parent, key, value);
+	free(key);
+	return 0;
+}
+
+/* Detach the item at pointer; it is returned with its key still attached. */
+static cJSON *patch_detach(cJSON *object, const char *path)
+{
+	const char *last = strrchr(path, '/');
+	cJSON *parent, *item;
+	if (!last)
+		return 0;
+	parent = resolve_pointer(object, path, last);
+	item = resolve_pointer(object, path, path + strlen(path));
+	if (!parent || !item || item == object)
+		return 0;
+	detach_item(parent, item);
+	return item;
+}
+
+static int apply_patch(cJSON *object, cJSON *patch)
+{
+	cJSON *op = cJSON_GetObjectItem(patch, "op"), *path = cJSON_GetObjectItem(patch, "path");
+	cJSON *value = cJSON_GetObjectItem(patch, "value"), *from = cJSON_GetObjectItem(patch, "from");
+	cJSON *item, *target;
+	const char *o;
+	size_t flen;
+	int err;
+
+	if (!op || !path || (op->type & 255) != cJSON_String || (path->type & 255) != cJSON_String)
+		return 1;
+	o = op->valuestring;
+
+	if (!strcmp(o, "test"))
+	{
+		target = cJSONUtils_GetPointer(object, path->valuestring);
+		return (target && value && cJSON_Compare(target, value, 1)) ? 0 : 10;
+	}
+	if (!strcmp(o, "remove"))
+	{
+		item = patch_detach(object, path->valuestring);
+		if (!item)
+			return 11;
+		cJSON_Delete(item);
+		return 0;
+	}
+	if (!strcmp(o, "replace"))
+	{
+		const char *last = strrchr(path->valuestring, '/');
+		if (!value)
+			return 12;
+		target = cJSONUtils_GetPointer(object, path->valuestring);
+		if (!target)
+			return 13;
+		item = cJSON_Duplicate(value, 1);
+		if (!item)
+			return 14;
+		if (target == object)
+		{
+			if (cJSON_ReplaceValue(object, item))
+				return 0;
+			cJSON_Delete(item);
+			return 14;
+		}
+		cJSON_ReplaceItemViaPointer(resolve_pointer(object, path->valuestring, last), target, item);
+		return 0;
+	}
+	if (!strcmp(o, "add"))
+	{
+		if (!value)
+			return 15;
+		item = cJSON_Duplicate(value, 1);
+		if (!item)
+			return 16;
+		err = patch_add(object, path->valuestring, item);
+		if (err)
+			cJSON_Delete(item);
+		return err;
+	}
+	if (!strcmp(o, "move") || !strcmp(o, "copy"))
+	{
+		if (!from || (from->type & 255) != cJSON_String)
+			return 17;
+		if (!strcmp(o, "move"))
+		{
+			/* A value cannot be moved into one of its own children. */
+			flen = strlen(from->valuestring);
+			if (!strncmp(path->valuestring, from->valuestring, flen) && path->valuestring[flen] == '/')
+				return 18;
+			if (!strcmp(path->valuestring, from->valuestring))
+				return 0;
+			item = patch_detach(object, from->valuestring);
+		}
+		else
+			item = cJSON_Duplicate(cJSONUtils_GetPointer(object, from->valuestring), 1);
+		if (!item)
+			return 19;
+		err = patch_add(object, path->valuestring, item);
+		if (err)
+			cJSON_Delete(item);
+		return err;
+	}
+	return 20; /* unknown op */
+}
+
+int cJSONUtils_ApplyPatches(cJSON *object, cJSON *patches)
+{
+	cJSON *patch;
+	int err;
+	if (!object || !patches || (patches->type & 255) != cJSON_Array)
+		return 1;
+	for (patch = patches->child; patch; patch = patch->next)
+		if ((err = apply_patch(object, patch)) != 0)
+			return err;
+	return 0;
+}
+
+/* JSON Merge Patch. */
+
+static cJSON *find_member(cJSON *object, const char *key)
+{
+	cJSON *c = object->child;
+	while (c && key_compare(c->string, key))
+		c = c->next;
+	return c;
+}
+
+cJSON *cJSONUtils_MergePatch(cJSON *target, cJSON *patch)
+{
+	cJSON *p, *member, *merged;
+	if (!patch)
+		return target;
+	if ((patch->type & 255) != cJSON_Object)
+	{
+		cJSON_Delete(target);
+		return cJSON_Duplicate(patch, 1);
+	}
+	if (!target || (target->type & 255) != cJSON_Object)
+	{
+		cJSON_Delete(target);
+		target = cJSON_CreateObject();
+		if (!target)
+			return 0;
+	}
+	for (p = patch->child; p; p = p->next)
+	{
+		member = find_member(target, p->string);
+		if ((p->type & 255) == cJSON_NULL)
+		{
+			if (member)
+			{
+				detach_item(target, member);
+				cJSON_Delete(member);
+			}
+		}
+		else if (member && (p->type & 255) == cJSON_Object && (member->type & 255) == cJSON_Object)
+			cJSONUtils_MergePatch(member, p); /* Merge into the existing node, in place. */
+		else if (member)
+		{
+			merged = cJSONUtils_MergePatch(0, p);
+			if (merged)
+				cJSON_ReplaceItemViaPointer(target, member, merged);
+		}
+		else
+		{
+			merged = cJSONUtils_MergePatch(0, p);
+			if (merged)
+				cJSON_AddItemToObject(target, p->string, merged);
+		}
+	}
+	return target;
+}
+
+static cJSON *merge_diff(utils_node *from, size_t fi, utils_node *to, size_t ti, int *fail)
+{
+	utils_member *fm, *tm;
+	int fn, tn, i = 0, j = 0, c;
+	cJSON *patch, *sub;
+
+	if (same_node(from, fi, to, ti))
+		return 0;
+	if ((from[fi].item->type & 255) != cJSON_Object || (to[ti].item->type & 255) != cJSON_Object)
+		return cJSON_Duplicate(to[ti].item, 1);
+
+	patch = cJSON_CreateObject();
+	fn = collect_members(from, fi, &fm);
+	tn = collect_members(to, ti, &tm);
+	if (!patch || fn < 0 || tn < 0)
+	{
+		free(fm), free(tm);
+		cJSON_Delete(patch);
+		*fail = 1;
+		return 0;
+	}
+	while (i < fn || j < tn)
+	{
+		if (i >= fn)
+			c = 1;
+		else if (j >= tn)
+			c = -1;
+		else
+			c = key_compare(fm[i].key, tm[j].key);
+
+		if (c < 0)
+			cJSON_AddItemToObject(patch, fm[i++].key, cJSON_CreateNull());
+		else if (c > 0)
+		{
+			cJSON_AddItemToObject(patch, tm[j].key, cJSON_Duplicate(to[tm[j].index].item, 1));
+			j++;
+		}
+		else
+		{
+			sub = merge_diff(from, fm[i].index, to, tm[j].index, fail);
+			if (sub)
+				cJSON_AddItemToObject(patch, tm[j].key, sub);
+			i++, j++;
+		}
+	}
+	free(fm);
+	free(tm);
+	return patch;
+}
+
+cJSON *cJSONUtils_GenerateMergePatch(cJSON *from, cJSON *to)
+{
+	utils_node *ft, *tt;
+	cJSON *patch = 0;
+	int fail = 0;
+	if (!to)
+		return 0;
+	if (!from)
+		return cJSON_Duplicate(to, 1);
+	ft = build_table(from);
+	tt = build_table(to);
+	if (ft && tt)
+		patch = merge_diff(ft, 0, tt, 0, &fail);
+	free(ft);
+	free(tt);
+	if (fail)
+	{
+		cJSON_Delete(patch);
+		return 0;
+	}
+	return patch;
+}
+
+/* JSON Schema.
+   A schema is compiled into flat tables: one schema_node per (sub)schema, each node's properties as a run of the property
+   table sorted by key, and each node's enum values as a run of the enum table. Subschemas are referred to by index, so
+   validation walks the document and the tables side by side and never looks at the schema's own tree again. */
+
+/* Types a node accepts. A number that is whole also counts as SCHEMA_INTEGER. */
+#define SCHEMA_NULL 1
+#define SCHEMA_BOOLEAN 2
+#define SCHEMA_INTEGER 4
+#define SCHEMA_NUMBER 8
+#define SCHEMA_STRING 16
+#define SCHEMA_ARRAY 32
+#define SCHEMA_OBJECT 64
+#define SCHEMA_ANY 127
+
+/* Numeric limits that apply. */
+#define SCHEMA_MIN 1
+#define SCHEMA_MAX 2
+#define SCHEMA_XMIN 4
+#define SCHEMA_XMAX 8
+
+typedef struct
+{
+	int types, checks;
+	cJSON_number minimum, maximum, xminimum, xmaximum;
+	int min_length, max_length, min_items, max_items, min_props, max_props;
+	int items;			/* node for every array element, -1 for any */
+	int rest;			/* node for object members not in properties, -1 for any */
+	int props, nprops;	/* run of the property table */
+	int nrequired;
+	int enums, nenums;	/* run of the enum table */
+} schema_node;
+
+typedef struct
+{
+	char *key;
+	int node;		/* -1 for any value (a required name without a properties entry) */
+	int required;	/* bit in the required mask, -1 if optional */
+} schema_prop;
+
+struct cJSONUtils_Schema
+{
+	schema_node *nodes;
+	schema_prop *props;
+	cJSON **enums;
+	int nnodes, nprops, nenums;
+	int node_cap, prop_cap, enum_cap;
+};
+
+#define SCHEMA_DEPTH 64
+#define SCHEMA_REQUIRED 64 /* required names per object, one bit each */
+
+/* Make room for need entries of size bytes in *array. */
+static int schema_grow(void **array, int *cap, int need, size_t size)
+{
+	void *grown;
+	int n = *cap ? *cap : 16;
+	if (need <= *cap)
+		return 1;
+	while (n < need)
+		n *= 2;
+	grown = realloc(*array, n * size);
+	if (!grown)
+		return 0;
+	*array = grown;
+	*cap = n;
+	return 1;
+}
+
+static int schema_type(cJSON *name)
+{
+	static const char *names[] = {"null", "boolean", "integer", "number", "string", "array", "object"};
+	int i;
+	if (!name || (name->type & 255) != cJSON_String)
+		return 0;
+	for (i = 0; i < 7; i++)
+		if (!strcmp(name->valuestring, names[i]))
+			return 1 << i;
+	return 0;
+}
+
+/* A non-negative count such as minLength. */
+static int schema_count(cJSON *value, int *out)
+{
+	if ((value->type & 255) != cJSON_Number || value->valuedouble < 0)
+		return 0;
+	*out = (value->valuedouble > INT_MAX) ? INT_MAX : (int)value->valuedouble;
+	return 1;
+}
+
+static char *schema_strdup(const char *str)
+{
+	size_t len = strlen(str) + 1;
+	char *copy = (char *)malloc(len);
+	if (copy)
+		memcpy(copy, str, len);
+	return copy;
+}
+
+static int schema_find(const cJSONUtils_Schema *s, int first, int count, const char *key)
+{
+	int i;
+	for (i = 0; i < count; i++)
+		if (!strcmp(s->props[first + i].key, key))
+			return i;
+	return -1;
+}
+
+static int prop_compare(const void *a, const void *b) { return strcmp(((const schema_prop *)a)->key, ((const schema_prop *)b)->key); }
+
+/* Keywords that only describe; anything else that is not compiled below makes the schema unsupported. */
+static int schema_annotation(const char *key)
+{
+	static const char *keys[] = {"$schema", "$id", "id", "$comment", "title", "description", "default", "examples", "format", "definitions", "$defs"};
+	int i;
+	for (i = 0; i < (int)(sizeof(keys) / sizeof(keys[0])); i++)
+		if (!strcmp(key, keys[i]))
+			return 1;
+	return 0;
+}
+
+static int compile_node(cJSONUtils_Schema *s, cJSON *schema, int depth);
+
+/* The properties and required keywords of node at: reserve a run of the property table, then compile the subschemas behind it. */
+static int compile_props(cJSONUtils_Schema *s, int at, cJSON *properties, cJSON *required, int depth)
+{
+	cJSON *c;
+	int first = s->nprops, count = 0, n = 0, nreq = 0, i;
+	for (c = properties ? properties->child : 0; c; c = c->next)
+		count++;
+	for (c = required ? required->child : 0; c; c = c->next)
+		count++;
+	if (!schema_grow((void **)&s->props, &s->prop_cap, first + count, sizeof(schema_prop)))
+		return 0;
+	for (i = 0; i < count; i++)
+		s->props[first + i].key = 0;
+	s->nprops += count;
+	for (c = properties ? properties->child : 0; c; c = c->next)
+	{
+		if (schema_find(s, first, n, c->string) >= 0)
+			continue; /* a repeated name: the first one counts */
+		if (!(s->props[first + n].key = schema_strdup(c->string)))
+			return 0;
+		s->props[first + n].node = -2; /* compiled below */
+		s->props[first + n++].required = -1;
+	}
+	for (c = required ? required->child : 0; c; c = c->next)
+	{
+		if ((c->type & 255) != cJSON_String)
+			return 0;
+		i = schema_find(s, first, n, c->valuestring);
+		if (i < 0)
+		{
+			if (!(s->props[first + n].key = schema_strdup(c->valuestring)))
+				return 0;
+			s->props[first + n].node = -1;
+			s->props[first + n].required = -1;
+			i = n++;
+		}
+		if (s->props[first + i].required < 0)
+		{
+			if (nreq == SCHEMA_REQUIRED)
+				return 0;
+			s->props[first + i].required = nreq++;
+		}
+	}
+	for (c = properties ? properties->child : 0; c; c = c->next)
+	{
+		i = schema_find(s, first, n, c->string);
+		if (s->props[first + i].node != -2)
+			continue;
+		s->props[first + i].node = compile_node(s, c, depth + 1);
+		if (s->props[first + i].node < 0)
+			return 0;
+	}
+	qsort(s->props + first, n, sizeof(schema_prop), prop_compare);
+	s->nodes[at].props = first;
+	s->nodes[at].nprops = n;
+	s->nodes[at].nrequired = nreq;
+	return 1;
+}
+
+/* Compile schema into a new node and return its index, or -1 if it cannot be compiled. */
+static int compile_node(cJSONUtils_Schema *s, cJSON *schema, int depth)
+{
+	cJSON *k, *c, *properties = 0, *required = 0;
+	int at, t, draft4_xmin = 0, draft4_xmax = 0, type;
+	schema_node *n;
+	if (depth > SCHEMA_DEPTH || !schema_grow((void **)&s->nodes, &s->node_cap, s->nnodes + 1, sizeof(schema_node)))
+		return -1;
+	at = s->nnodes++;
+	n = &s->nodes[at];
+	memset(n, 0, sizeof(schema_node));
+	n->types = SCHEMA_ANY;
+	n->max_length = n->max_items = n->max_props = INT_MAX;
+	n->items = n->rest = -1;
+	type = schema->type & 255;
+	if (type == cJSON_True)
+		return at;
+	if (type == cJSON_False)
+	{
+		n->types = 0;
+		return at;
+	}
+	if (type != cJSON_Object)
+		return -1;
+
+	for (k = schema->child; k; k = k->next)
+	{
+		n = &s->nodes[at]; /* compiling a subschema may have moved the table */
+		type = k->type & 255;
+		if (!strcmp(k->string, "type"))
+		{
+			if (type == cJSON_Array)
+				for (n->types = 0, c = k->child; c; c = c->next)
+				{
+					if (!(t = schema_type(c)))
+						return -1;
+					n->types |= t;
+				}
+			else if (!(n->types = schema_type(k)))
+				return -1;
+		}
+		else if (!strcmp(k->string, "enum"))
+		{
+			if (type != cJSON_Array)
+				return -1;
+			n->enums = s->nenums;
+			for (c = k->child; c; c = c->next)
+			{
+				if (!schema_grow((void **)&s->enums, &s->enum_cap, s->nenums + 1, sizeof(cJSON *)))
+					return -1;
+				if (!(s->enums[s->nenums] = cJSON_Duplicate(c, 1)))
+					return -1;
+				s->nenums++;
+				s->nodes[at].nenums++;
+			}
+		}
+		else if (!strcmp(k->string, "minimum") && type == cJSON_Number)
+			n->checks |= SCHEMA_MIN, n->minimum = k->valuedouble;
+		else if (!strcmp(k->string, "maximum") && type == cJSON_Number)
+			n->checks |= SCHEMA_MAX, n->maximum = k->valuedouble;
+		else if (!strcmp(k->string, "exclusiveMinimum") && type == cJSON_Number)
+			n->checks |= SCHEMA_XMIN, n->xminimum = k->valuedouble;
+		else if (!strcmp(k->string, "exclusiveMaximum") && type == cJSON_Number)
+			n->checks |= SCHEMA_XMAX, n->xmaximum = k->valuedouble;
+		else if (!strcmp(k->string, "exclusiveMinimum") && (type == cJSON_True || type == cJSON_False))
+			draft4_xmin = (type == cJSON_True); /* draft 4: makes minimum exclusive */
+		else if (!strcmp(k->string, "exclusiveMaximum") && (type == cJSON_True || type == cJSON_False))
+			draft4_xmax = (type == cJSON_True);
+		else if (!strcmp(k->string, "minLength"))
+		{
+			if (!schema_count(k, &n->min_length))
+				return -1;
+		}
+		else if (!strcmp(k->string, "maxLength"))
+		{
+			if (!schema_count(k, &n->max_length))
+				return -1;
+		}
+		else if (!strcmp(k->string, "minItems"))
+		{
+			if (!schema_count(k, &n->min_items))
+				return -1;
+		}
+		else if (!strcmp(k->string, "maxItems"))
+		{
+			if (!schema_count(k, &n->max_items))
+				return -1;
+		}
+		else if (!strcmp(k->string, "minProperties"))
+		{
+			if (!schema_count(k, &n->min_props))
+				return -1;
+		}
+		else if (!strcmp(k->string, "maxProperties"))
+		{
+			if (!schema_count(k, &n->max_props))
+				return -1;
+		}
+		else if (!strcmp(k->string, "items") && type != cJSON_Array) /* one schema for every element; tuples are not supported */
+		{
+			if ((t = compile_node(s, k, depth + 1)) < 0)
+				return -1;
+			s->nodes[at].items = t;
+		}
+		else if (!strcmp(k->string, "additionalProperties"))
+		{
+			if ((t = compile_node(s, k, depth + 1)) < 0)
+				return -1;
+			s->nodes[at].rest = t;
+		}
+		else if (!strcmp(k->string, "properties") && type == cJSON_Object)
+			properties = k;
+		else if (!strcmp(k->string, "required") && type == cJSON_Array)
+			required = k;
+		else if (!schema_annotation(k->string))
+			return -1;
+	}
+	n = &s->nodes[at];
+	if (draft4_xmin && (n->checks & SCHEMA_MIN))
+		n->checks = (n->checks & ~SCHEMA_MIN) | SCHEMA_XMIN, n->xminimum = n->minimum;
+	if (draft4_xmax && (n->checks & SCHEMA_MAX))
+		n->checks = (n->checks & ~SCHEMA_MAX) | SCHEMA_XMAX, n->xmaximum = n->maximum;
+	if ((properties || required) && !compile_props(s, at, properties, required, depth))
+		return -1;
+	return at;
+}
+
+void cJSONUtils_FreeSchema(cJSONUtils_Schema *schema)
+{
+	int i;
+	if (!schema)
+		return;
+	for (i = 0; i < schema->nprops; i++)
+		free(schema->props[i].key);
+	for (i = 0; i < schema->nenums; i++)
+		cJSON_Delete(schema->enums[i]);
+	free(schema->nodes);
+	free(schema->props);
+	free(schema->enums);
+	free(schema);
+}
+
+cJSONUtils_Schema *cJSONUtils_CompileSchema(cJSON *schema)
+{
+	cJSONUtils_Schema *s;
+	if (!schema || !(s = (cJSONUtils_Schema *)calloc(1, sizeof(cJSONUtils_Schema))))
+		return 0;
+	if (compile_node(s, schema, 0) < 0)
+	{
+		cJSONUtils_FreeSchema(s);
+		return 0;
+	}
+	return s;
+}
+
+/* Validation. */
+
+#ifdef cJSON_NO_FLOAT
+#define number_type(d) SCHEMA_INTEGER
+#else
+static int number_type(double d)
+{
+	if (d > -9007199254740992.0 && d < 9007199254740992.0 && d != (double)(int64_t)d)
+		return SCHEMA_NUMBER;
+	return SCHEMA_INTEGER; /* past 2^53 every double is whole */
+}
+#endif
+
+static int type_allowed(const schema_node *n, int type)
+{
+	return (n->types & type) || (type == SCHEMA_INTEGER && (n->types & SCHEMA_NUMBER));
+}
+
+static int match_number(const cJSONUtils_Schema *s, const schema_node *n, int type, cJSON_number d)
+{
+	cJSON *e;
+	int i;
+	if (!type_allowed(n, type))
+		return 0;
+	if (((n->checks & SCHEMA_MIN) && d < n->minimum) || ((n->checks & SCHEMA_MAX) && d > n->maximum))
+		return 0;
+	if (((n->checks & SCHEMA_XMIN) && d <= n->xminimum) || ((n->checks & SCHEMA_XMAX) && d >= n->xmaximum))
+		return 0;
+	if (!n->nenums)
+		return 1;
+	for (i = 0; i < n->nenums; i++)
+	{
+		e = s->enums[n->enums + i];
+		if ((e->type & 255) == cJSON_Number && !(e->type & cJSON_NumberIsText) && e->valuedouble == d)
+			return 1;
+	}
+	return 0;
+}
+
+/* length is in characters (code points), as JSON Schema counts them. */
+static int match_string(const cJSONUtils_Schema *s, const schema_node *n, const char *str, int length)
+{
+	cJSON *e;
+	int i;
+	if (!type_allowed(n, SCHEMA_STRING) || length < n->min_length || length > n->max_length)
+		return 0;
+	if (!n->nenums)
+		return 1;
+	for (i = 0; i < n->nenums; i++)
+	{
+		e = s->enums[n->enums + i];
+		if ((e->type & 255) == cJSON_String && e->valuestring && !strcmp(e->valuestring, str))
+			return 1;
+	}
+	return 0;
+}
+
+/* A binary value is checked as the base64 string it prints as. */
+static int match_binary(const cJSONUtils_Schema *s, const schema_node *n, cJSON *item)
+{
+	char *text = (char *)malloc(cJSON_BINARY_SPACE(item->valueint)), *end;
+	int ok;
+	if (!text)
+		return 0;
+	end = cJSON_FormatBinary(text, item->valuestring, item->valueint);
+	end[-1] = 0; /* drop the closing quote */
+	ok = match_string(s, n, text + 1, (int)(end - text) - 2);
+	free(text);
+	return ok;
+}
+
+/* null, false or true: cJSON_NULL, cJSON_False or cJSON_True. */
+static int match_literal(const cJSONUtils_Schema *s, const schema_node *n, int literal)
+{
+	int i;
+	if (!type_allowed(n, (literal == cJSON_NULL) ? SCHEMA_NULL : SCHEMA_BOOLEAN))
+		return 0;
+	if (!n->nenums)
+		return 1;
+	for (i = 0; i < n->nenums; i++)
+		if ((s->enums[n->enums + i]->type & 255) == literal)
+			return 1;
+	return 0;
+}
+
+static int match_enum(const cJSONUtils_Schema *s, const schema_node *n, cJSON *item)
+{
+	int i;
+	if (!n->nenums)
+		return 1;
+	for (i = 0; i < n->nenums; i++)
+		if (cJSON_Compare(s->enums[n->enums + i], item, 1))
+			return 1;
+	return 0;
+}
+
+/* Binary search of node n's properties for key[0..length). */
+static const schema_prop *match_prop(const cJSONUtils_Schema *s, const schema_node *n, const char *key, size_t length)
+{
+	int lo = 0, hi = n->nprops, mid, c;
+	const schema_prop *p;
+	while (lo < hi)
+	{
+		mid = (lo + hi) / 2;
+		p = &s->props[n->props + mid];
+		c = strncmp(p->key, key, length);
+		if (!c)
+			c = p->key[length] ? 1 : 0;
+		if (!c)
+			return p;
+		if (c < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return 0;
+}
+
+static uint64_t required_mask(const schema_node *n)
+{
+	return (n->nrequired == SCHEMA_REQUIRED) ? ~(uint64_t)0 : (((uint64_t)1 << n->nrequired) - 1);
+}
+
+static int utf8_length(const char *str)
+{
+	int n = 0;
+	for (; *str; str++)
+		if ((*str & 0xC0) != 0x80)
+			n++;
+	return n;
+}
+
+static int validate_item(const cJSONUtils_Schema *s, int at, cJSON *item)
+{
+	const schema_node *n;
+	const schema_prop *p;
+	cJSON *c;
+	uint64_t seen = 0;
+	int count = 0, i, type;
+	if (at < 0)
+		return 1;
+	n = &s->nodes[at];
+	switch (item->type & 255)
+	{
+	case cJSON_NULL:
+	case cJSON_False:
+	case cJSON_True:
+		return match_literal(s, n, item->type & 255);
+	case cJSON_Number:
+		type = (item->type & cJSON_NumberIsText) ? SCHEMA_NUMBER : number_type(item->valuedouble);
+		return match_number(s, n, type, item->valuedouble);
+	case cJSON_String:
+		if (item->type & cJSON_StringIsBinary)
+			return match_binary(s, n, item);
+		return item->valuestring && match_string(s, n, item->valuestring, utf8_length(item->valuestring));
+	case cJSON_Array:
+		if (!type_allowed(n, SCHEMA_ARRAY))
+			return 0;
+		if (item->type & cJSON_IsPacked)
+		{
+			count = item->valueint;
+			for (i = 0; i < count && n->items >= 0; i++)
+			{
+#ifndef cJSON_NO_FLOAT
+				if (item->type & cJSON_PackedDouble)
+				{
+					double d = ((double *)item->valuestring)[i];
+					if (!match_number(s, &s->nodes[n->items], number_type(d), d))
+						return 0;
+				}
+				else
+#endif
+				if (!match_number(s, &s->nodes[n->items], SCHEMA_INTEGER, (item->type & cJSON_PackedInt32) ? ((int32_t *)item->valuestring)[i] : ((int64_t *)item->valuestring)[i]))
+					return 0;
+			}
+		}
+		else
+			for (c = item->child; c; c = c->next, count++)
+				if (!validate_item(s, n->items, c))
+					return 0;
+		return count >= n->min_items && count <= n->max_items && match_enum(s, n, item);
+	case cJSON_Object:
+		if (!type_allowed(n, SCHEMA_OBJECT))
+			return 0;
+		for (c = item->child; c; c = c->next, count++)
+		{
+			p = c->string ? match_prop(s, n, c->string, strlen(c->string)) : 0;
+			if (p && p->required >= 0)
+				seen |= (uint64_t)1 << p->required;
+			if (!validate_item(s, p ? p->node : n->rest, c))
+				return 0;
+		}
+		return count >= n->min_props && count <= n->max_props && seen == required_mask(n) && match_enum(s, n, item);
+	}
+	return 0;
+}
+
+int cJSONUtils_Validate(const cJSONUtils_Schema *schema, cJSON *item)
+{
+	if (!schema || !item)
+		return 0;
+	return validate_item(schema, 0, item);
+}
+
+/* Validating text: one pass over it, no nodes built. */
+
+typedef struct
+{
+	const cJSONUtils_Schema *s;
+	const char *fail; /* where the first mismatch was found */
+} schema_text;
+
+static const char *text_fail(schema_text *t, const char *at)
+{
+	if (!t->fail)
+		t->fail = at;
+	return 0;
+}
+
+static int hex4(const char *in)
+{
+	int i, v = 0;
+	for (i = 0; i < 4; i++, in++)
+	{
+		v <<= 4;
+		if (*in >= '0' && *in <= '9')
+			v += *in - '0';
+		else if ((*in | 32) >= 'a' && (*in | 32) <= 'f')
+			v += (*in | 32) - 'a' + 10;
+		else
+			return -1;
+	}
+	return v;
+}
+
+/* Characters in the string literal at str (its opening quote), counted one per code point, with *end set past the closing
+   quote and *plain set if it has no escapes. Returns -1 if the literal is malformed. */
+static int literal_length(const char *str, const char **end, int *plain)
+{
+	const unsigned char *ptr = (const unsigned char *)str + 1;
+	int n = 0, u;
+	*plain = 1;
+	while (*ptr != '\"')
+	{
+		if (*ptr < 32)
+			return -1;
+		if (*ptr == '\\')
+		{
+			*plain = 0;
+			if (ptr[1] == 'u')
+			{
+				if ((u = hex4((const char *)ptr + 2)) < 0)
+					return -1;
+				ptr += 6;
+				if (u < 0xDC00 || u > 0xDFFF) /* the low half of a surrogate pair goes with the high half */
+					n++;
+				continue;
+			}
+			if (!strchr("\"\\/bfnrt", ptr[1]) || !ptr[1])
+				return -1;
+			ptr += 2;
+			n++;
+			continue;
+		}
+		if ((*ptr & 0xC0) != 0x80)
+			n++;
+		ptr++;
+	}
+	*end = (const char *)ptr + 1;
+	return n;
+}
+
+/* The unescaped text of the literal at str, in buffer if it fits (size bytes) or else on the heap. */
+static char *literal_text(const char *str, char *buffer, int size)
+{
+	int need = cJSON_ScanStringSize(str);
+	char *out = (need <= size) ? buffer : (char *)malloc(need);
+	if (out && !cJSON_ScanString(str, out))
+	{
+		if (out != buffer)
+			free(out);
+		return 0;
+	}
+	return out;
+}
+
+/* enum with an array or object value: that one value is parsed to compare it. */
+static const char *text_enum(schema_text *t, const schema_node *n, const char *in, const char *end)
+{
+	cJSON_Context ctx;
+	cJSON *item;
+	int ok;
+	if (!n->nenums)
+		return end;
+	cJSON_InitContext(&ctx);
+	item = cJSON_ParseWithContext(&ctx, in, 0);
+	ok = item && match_enum(t->s, n, item);
+	if (item)
+		cJSON_DeleteWithContext(&ctx, item);
+	return ok ? end : text_fail(t, in);
+}
+
+static const char *validate_text(schema_text *t, int at, const char *in);
+
+/* The number in[0..end), scanned into d, is SCHEMA_INTEGER or SCHEMA_NUMBER. */
+static int text_number_type(const char *in, const char *end, cJSON_number d)
+{
+#ifdef cJSON_NO_FLOAT
+	(void)d;
+	for (; in < end; in++)
+		if (*in == '.' || *in == 'e' || *in == 'E')
+			return SCHEMA_NUMBER; /* the parser keeps these as text */
+	return SCHEMA_INTEGER;
+#else
+	(void)in;
+	(void)end;
+	return number_type(d);
+#endif
+}
+
+static const char *text_array(schema_text *t, const schema_node *n, const char *in)
+{
+	const char *start = in;
+	int count = 0;
+	in = cJSON_SkipWhitespace(in + 1);
+	if (*in != ']')
+		for (;;)
+		{
+			if (!(in = validate_text(t, n->items, in)))
+				return 0;
+			count++;
+			in = cJSON_SkipWhitespace(in);
+			if (*in == ']')
+				break;
+			if (*in != ',')
+				return text_fail(t, in);
+			in = cJSON_SkipWhitespace(in + 1);
+		}
+	if (count < n->min_items || count > n->max_items)
+		return text_fail(t, start);
+	return text_enum(t, n, start, in + 1);
+}
+
+static const char *text_object(schema_text *t, const schema_node *n, const char *in)
+{
+	const char *start = in, *end;
+	const schema_prop *p;
+	char buffer[256], *key;
+	uint64_t seen = 0;
+	int count = 0, plain;
+	in = cJSON_SkipWhitespace(in + 1);
+	if (*in != '}')
+		for (;;)
+		{
+			if (*in != '\"' || literal_length(in, &end, &plain) < 0)
+				return text_fail(t, in);
+			if (plain)
+				p = match_prop(t->s, n, in + 1, end - in - 2);
+			else
+			{
+				if (!(key = literal_text(in, buffer, sizeof(buffer))))
+					return text_fail(t, in);
+				p = match_prop(t->s, n, key, strlen(key));
+				if (key != buffer)
+					free(key);
+			}
+			if (p && p->required >= 0)
+				seen |= (uint64_t)1 << p->required;
+			in = cJSON_SkipWhitespace(end);
+			if (*in != ':')
+				return text_fail(t, in);
+			if (!(in = validate_text(t, p ? p->node : n->rest, cJSON_SkipWhitespace(in + 1))))
+				return 0;
+			count++;
+			in = cJSON_SkipWhitespace(in);
+			if (*in == '}')
+				break;
+			if (*in != ',')
+				return text_fail(t, in);
+			in = cJSON_SkipWhitespace(in + 1);
+		}
+	if (count < n->min_props || count > n->max_props || seen != required_mask(n))
+		return text_fail(t, start);
+	return text_enum(t, n, start, in + 1);
+}
+
+/* Check the value at in against node at. Returns the end of the value, or 0 (with t->fail set) if it is malformed or does not match. */
+static const char *validate_text(schema_text *t, int at, const char *in)
+{
+	const schema_node *n;
+	const char *end;
+	char buffer[256], *str;
+	cJSON_number d;
+	int length, plain, ok;
+	if (at < 0)
+		return (end = cJSON_SkipValue(in)) ? end : text_fail(t, in);
+	n = &t->s->nodes[at];
+	switch (*in)
+	{
+	case 'n':
+		return (!strncmp(in, "null", 4) && match_literal(t->s, n, cJSON_NULL)) ? in + 4 : text_fail(t, in);
+	case 'f':
+		return (!strncmp(in, "false", 5) && match_literal(t->s, n, cJSON_False)) ? in + 5 : text_fail(t, in);
+	case 't':
+		return (!strncmp(in, "true", 4) && match_literal(t->s, n, cJSON_True)) ? in + 4 : text_fail(t, in);
+	case '\"':
+		if ((length = literal_length(in, &end, &plain)) < 0)
+			return text_fail(t, in);
+		if (!n->nenums) /* the length is all that is needed */
+			return match_string(t->s, n, "", length) ? end : text_fail(t, in);
+		if (!(str = literal_text(in, buffer, sizeof(buffer))))
+			return text_fail(t, in);
+		ok = match_string(t->s, n, str, length);
+		if (str != buffer)
+			free(str);
+		return ok ? end : text_fail(t, in);
+	case '[':
+		return type_allowed(n, SCHEMA_ARRAY) ? text_array(t, n, in) : text_fail(t, in);
+	case '{':
+		return type_allowed(n, SCHEMA_OBJECT) ? text_object(t, n, in) : text_fail(t, in);
+	}
+	if (*in != '-' && (*in < '0' || *in > '9'))
+		return text_fail(t, in);
+	if (in[*in == '-'] < '0' || in[*in == '-'] > '9')
+		return text_fail(t, in);
+	end = cJSON_ScanNumber(in, &d);
+	return match_number(t->s, n, text_number_type(in, end, d), d) ? end : text_fail(t, in);
+}
+
+int cJSONUtils_ValidateText(const cJSONUtils_Schema *schema, const char *text, const char **fail)
+{
+	schema_text t;
+	const char *end;
+	if (fail)
+		*fail = text;
+	if (!schema || !text)
+		return 0;
+	t.s = schema;
+	t.fail = 0;
+	end = validate_text(&t, 0, cJSON_SkipWhitespace(text));
+	if (end && *(end = cJSON_SkipWhitespace(end)))
+		end = text_fail(&t, end);
+	if (fail)
+		*fail = end ? 0 : t.fail;
+	return end != 0;
+}
@@ -0,0 +1,128 @@
+/*
+  Copyright (c) 2009 Dave Gamble
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+/* cJSON_Reflect.hpp against the DOM, on one record with 12 members, nested objects and arrays.
+
+	gcc -O2 -c -Iinc src/cJSON.c
+	g++ -O2 -std=c++17 -Iinc user/bench_reflect.cpp cJSON.o -o bench_reflect
+
+   Parsing is timed as cJSON_Parse plus reading every member back out, since that is the work the codec replaces;
+   printing as cJSON_PrintUnformatted of the equivalent tree. */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "cJSON_Reflect.hpp"
+
+namespace bench
+{
+struct Size { int width, height; };
+struct Image { std::string url; Size size; };
+struct Record
+{
+	int id;
+	std::string name;
+	double lat, lon;
+	bool active;
+	std::string city, state, zip, country;
+	std::vector<int> ids;
+	std::vector<std::string> tags;
+	Image image;
+};
+CJSON_REFLECT(Size, width, height)
+CJSON_REFLECT(Image, url, size)
+CJSON_REFLECT(Record, id, name, lat, lon, active, city, state, zip, country, ids, tags, image)
+}
+
+static const char text[] = "{\"id\":38793,\"name\":\"Jack (\\\"Bee\\\") Nimble\",\"lat\":37.7668,\"lon\":-122.3959,\"active\":true,"
+						   "\"city\":\"SAN FRANCISCO\",\"state\":\"CA\",\"zip\":\"94107\",\"country\":\"US\",\"ids\":[116,943,234,38793],"
+						   "\"tags\":[\"rect\",\"interlace\",\"frame\"],\"image\":{\"url\":\"http://www.example.com/image/481989943\","
+						   "\"size\":{\"width\":800,\"height\":600}}}";
+
+/* What the codec does for Record, the DOM way. */
+static void from_tree(cJSON *root, bench::Record &r)
+{
+	cJSON *c, *image = cJSON_GetObjectItem(root, "image"), *size = cJSON_GetObjectItem(image, "size");
+	r.id = cJSON_GetObjectItem(root, "id")->valueint;
+	r.name = cJSON_GetObjectItem(root, "name")->valuestring;
+	r.lat = cJSON_GetObjectItem(root, "lat")->valuedouble;
+	r.lon = cJSON_GetObjectItem(root, "lon")->valuedouble;
+	r.active = cJSON_GetObjectItem(root, "active")->type == cJSON_True;
+	r.city = cJSON_GetObjectItem(root, "city")->valuestring;
+	r.state = cJSON_GetObjectItem(root, "state")->valuestring;
+	r.zip = cJSON_GetObjectItem(root, "zip")->valuestring;
+	r.country = cJSON_GetObjectItem(root, "country")->valuestring;
+	r.ids.clear();
+	for (c = cJSON_GetObjectItem(root, "ids")->child; c; c = c->next)
+		r.ids.push_back(c->valueint);
+	r.tags.clear();
+	for (c = cJSON_GetObjectItem(root, "tags")->child; c; c = c->next)
+		r.tags.push_back(c->valuestring);
+	r.image.url = cJSON_GetObjectItem(image, "url")->valuestring;
+	r.image.size.width = cJSON_GetObjectItem(size, "width")->valueint;
+	r.image.size.height = cJSON_GetObjectItem(size, "height")->valueint;
+}
+
+template <class F>
+static double time_us(int rounds, F &&f)
+{
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < rounds; i++)
+		f();
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+}
+
+int main(int argc, const char *argv[])
+{
+	int rounds = (argc > 1) ? std::atoi(argv[1]) : 200000;
+	bench::Record r{};
+	cJSON *tree = cJSON_Parse(text);
+	std::string out;
+	char *dom;
+	volatile std::size_t sink = 0;
+
+	/* Both paths must agree before their timings mean anything. */
+	if (!tree || !cjson::parse(text, r))
+		return std::printf("parse failed\n"), 1;
+	out = cjson::print(r, false);
+	dom = cJSON_PrintUnformatted(tree);
+	if (out != dom)
+		return std::printf("outputs differ:\n%s\n%s\n", out.c_str(), dom), 1;
+	std::free(dom);
+
+	std::printf("parse  reflect %.2fus", time_us(rounds, [&] { cjson::parse(text, r); sink = sink + r.ids.size(); }));
+	std::printf("  dom %.2fus\n", time_us(rounds, [&] {
+		cJSON *root = cJSON_Parse(text);
+		from_tree(root, r);
+		cJSON_Delete(root);
+		sink = sink + r.ids.size();
+	}));
+	std::printf("print  reflect %.2fus", time_us(rounds, [&] { sink = sink + cjson::print(r, false).size(); }));
+	std::printf("  dom %.2fus\n", time_us(rounds, [&] {
+		char *s = cJSON_PrintUnformatted(tree);
+		sink = sink + std::strlen(s);
+		std::free(s);
+	}));
+	cJSON_Delete(tree);
+	return 0;
+}
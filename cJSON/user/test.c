@@ -22,7 +22,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "cJSON.h"
+#include "cJSON_Utils.h"
 
 /* Parse text to JSON, then render back to text, and print! */
 void doit(char *text)
@@ -133,6 +135,247 @@ void create_objects()
 
 }
 
+/* Parse through a pooled context with packed numbers, then grow the packed array, which unpacks it through the same pool. */
+void pool_packed()
+{
+	cJSON_Context ctx;cJSON_Pool pool;cJSON *root,*w;char *out;
+
+	cJSON_InitContext(&ctx);
+	cJSON_InitPool(&pool,&ctx,16);
+	ctx.flags|=cJSON_CtxPackNumbers;
+
+	root=cJSON_ParseWithContext(&ctx,"{\"w\":[1,2,3,4]}",0);
+	w=cJSON_GetObjectItem(root,"w");
+	cJSON_AddItemToArray(w,cJSON_ParseWithContext(&ctx,"5",0));	/* the new item comes from ctx too */
+
+	out=cJSON_PrintWithContext(&ctx,root,0);	cJSON_DeleteWithContext(&ctx,root);	printf("%s\n",out);	ctx.free_fn(ctx.userdata,out);
+	cJSON_TrimPool(&pool,0);
+}
+
+/* The checks below print one line each and make main return 1 if any of them fails. */
+static int failures=0;
+static void check(const char *what,int ok)
+{
+	printf("%-24s %s\n",what,ok?"ok":"FAILED");
+	if (!ok) failures++;
+}
+
+/* Patches generated between two documents turn the first into the second, and so does the merge patch. */
+void patch_roundtrip()
+{
+	cJSON *from=cJSON_Parse("{\"x\":[1,2,{\"q\":3},4],\"y\":\"s\",\"gone\":true}");
+	cJSON *to=cJSON_Parse("{\"x\":[1,2,{\"q\":5},4,6],\"y\":\"s\",\"z\":{\"n\":null}}");
+	cJSON *doc=cJSON_Duplicate(from,1),*patches=cJSONUtils_GeneratePatches(from,to),*merge;
+
+	check("patch round-trip",!cJSONUtils_ApplyPatches(doc,patches) && cJSON_Compare(doc,to,1));
+	cJSON_Delete(doc);	cJSON_Delete(patches);
+
+	/* A patch that replaces the whole document. */
+	doc=cJSON_Duplicate(from,1);	patches=cJSON_CreateArray();
+	cJSONUtils_AddPatchToArray(patches,"replace","",to);
+	check("patch whole document",!cJSONUtils_ApplyPatches(doc,patches) && cJSON_Compare(doc,to,0));
+	cJSON_Delete(doc);	cJSON_Delete(patches);
+
+	/* z holds a null, which a merge patch cannot express, so drop it first. */
+	cJSON_DeleteItemFromObject(to,"z");
+	merge=cJSONUtils_GenerateMergePatch(from,to);
+	doc=cJSONUtils_MergePatch(cJSON_Duplicate(from,1),merge);
+	check("merge patch round-trip",cJSON_Compare(doc,to,1));
+	cJSON_Delete(doc);	cJSON_Delete(merge);	cJSON_Delete(from);	cJSON_Delete(to);
+}
+
+/* Parse from a buffer that has no terminating null: nothing past length may be read (run under ASan to see that). */
+void parse_length()
+{
+	static const char text[]="{\"a\":[1,2,3],\"b\":\"xyz\"}";
+	size_t len=sizeof(text)-1;
+	char *buf=(char*)malloc(len);cJSON *root;const char *end;
+
+	memcpy(buf,text,len);
+	root=cJSON_ParseWithLengthOpts(buf,len,&end,1);
+	check("parse with length",root && end==buf+len && !strcmp(cJSON_GetObjectItem(root,"b")->valuestring,"xyz"));
+	cJSON_Delete(root);
+	check("parse cut short",!cJSON_ParseWithLength(buf,len-1) && !cJSON_ParseWithLength(buf,7));
+	free(buf);
+}
+
+/* The sink and parallel printers give exactly the text cJSON_Print does. */
+struct text_sink {char text[1024];int len;};
+static int write_text(void *sink,const char *data,int size)
+{
+	struct text_sink *t=(struct text_sink*)sink;
+	if (t->len+size>=(int)sizeof(t->text)) return 0;
+	memcpy(t->text+t->len,data,size);t->len+=size;t->text[t->len]=0;
+	return size;
+}
+/* Runs the jobs backwards on the calling thread, so the output only comes out right if the pieces are joined in order. */
+static void run_backwards(void *pool,void (*job)(void *arg,int index),void *arg,int count)
+{
+	(void)pool;
+	while (count--) job(arg,count);
+}
+void print_sink_parallel()
+{
+	cJSON *root=cJSON_Parse("{\"name\":\"a long enough string value\",\"list\":[1,2.5,\"three\",[4],{\"five\":5},null,true,false,-9,10],\"empty\":{}}");
+	char *out=cJSON_Print(root),*plain=cJSON_PrintUnformatted(root),*par_out;
+	struct text_sink sink;char buffer[8];
+	cJSON_Parallel par={run_backwards,0,4,3};
+
+	sink.len=0;
+	check("print to sink",cJSON_PrintToSink(root,1,buffer,sizeof(buffer),write_text,&sink) && !strcmp(sink.text,out));
+	par_out=cJSON_PrintParallel(root,1,&par);
+	check("print parallel",par_out && !strcmp(par_out,out));
+	free(par_out);
+	par_out=cJSON_PrintParallel(root,0,&par);
+	check("print parallel plain",par_out && !strcmp(par_out,plain));
+	free(par_out);	free(plain);	free(out);	cJSON_Delete(root);
+}
+
+/* A struct read from and written back to JSON through a field table. */
+struct entry {int id;char *name;char zip[8];int ids[4];int nids;};
+static const cJSON_Field id_element=cJSON_ELEMENT(cJSON_FieldInt,int);
+static const cJSON_Field entry_fields[]={
+	cJSON_FIELD("id",cJSON_FieldInt,struct entry,id),
+	cJSON_FIELD("name",cJSON_FieldString,struct entry,name),
+	cJSON_FIELD("zip",cJSON_FieldChars,struct entry,zip),
+	cJSON_FIELD_ARRAY("ids",struct entry,ids,nids,id_element)};
+void struct_codec()
+{
+	const int count=sizeof(entry_fields)/sizeof(*entry_fields);
+	static const char text[]="{\"id\":7,\"name\":\"Jack\",\"zip\":\"94107\",\"ids\":[116,943,234],\"other\":[{}]}";
+	struct entry r;char *out;
+
+	memset(&r,0,sizeof(r));
+	check("struct parse",cJSON_ParseStruct(text,entry_fields,count,&r) && r.id==7 && !strcmp(r.name,"Jack")
+		&& !strcmp(r.zip,"94107") && r.nids==3 && r.ids[2]==234);
+	out=cJSON_PrintStruct(&r,entry_fields,count,0);
+	check("struct print",out && !strcmp(out,"{\"id\":7,\"name\":\"Jack\",\"zip\":\"94107\",\"ids\":[116,943,234]}"));
+	free(out);	cJSON_FreeStruct(&r,entry_fields,count);
+
+	/* Values that do not fit their member fail the parse. */
+	memset(&r,0,sizeof(r));
+	check("struct int out of range",!cJSON_ParseStruct("{\"id\":3000000000}",entry_fields,count,&r));
+	check("struct chars too long",!cJSON_ParseStruct("{\"zip\":\"123456789\"}",entry_fields,count,&r));
+	check("struct array too long",!cJSON_ParseStruct("{\"ids\":[1,2,3,4,5]}",entry_fields,count,&r));
+	cJSON_FreeStruct(&r,entry_fields,count);
+}
+
+/* NDJSON, read a few bytes at a time so records straddle reads; a bad line is reported and skipped. */
+struct text_source {const char *text;};
+static int read_text(void *source,char *buffer,int size)
+{
+	struct text_source *t=(struct text_source*)source;
+	int n=(int)strlen(t->text);
+	if (n>size) n=size;
+	if (n>5) n=5;
+	memcpy(buffer,t->text,n);t->text+=n;
+	return n;
+}
+void ndjson()
+{
+	struct text_source source={"{\"n\":1}\n\n[2,\"two\"]\r\n{bad\n\"last\""};
+	cJSON_Stream s;cJSON *record;int r1,r2,r3,r4,r5;
+
+	if (!cJSON_InitStream(&s,0,read_text,&source)) {check("ndjson",0);return;}
+	r1=cJSON_StreamNext(&s,&record);	r1=r1==1 && cJSON_GetObjectItem(record,"n")->valueint==1;
+	r2=cJSON_StreamNext(&s,&record);	r2=r2==1 && cJSON_GetArraySize(record)==2;
+	r3=cJSON_StreamNext(&s,&record)==-1;
+	r4=cJSON_StreamNext(&s,&record);	r4=r4==1 && !strcmp(record->valuestring,"last") && s.line==5;
+	r5=cJSON_StreamNext(&s,&record)==0;
+	check("ndjson",r1 && r2 && r3 && r4 && r5);
+	cJSON_FreeStream(&s);
+}
+
+/* One compiled schema checks both trees and raw text. */
+void schema()
+{
+	cJSON *def=cJSON_Parse("{\"type\":\"object\",\"required\":[\"id\"],\"additionalProperties\":false,\"properties\":{"
+		"\"id\":{\"type\":\"integer\",\"minimum\":1},\"tags\":{\"type\":\"array\",\"maxItems\":2,\"items\":{\"type\":\"string\",\"maxLength\":4}}}}");
+	cJSONUtils_Schema *s=cJSONUtils_CompileSchema(def);
+	cJSON *good=cJSON_Parse("{\"id\":3,\"tags\":[\"a\",\"bc\"]}"),*bad=cJSON_Parse("{\"id\":3,\"tags\":[\"toolong\"]}");
+	const char *text="{\"id\":0}",*fail=0;
+
+	check("schema compile",s!=0);
+	check("schema tree",s && cJSONUtils_Validate(s,good) && !cJSONUtils_Validate(s,bad));
+	check("schema text",s && cJSONUtils_ValidateText(s,"{\"tags\":[],\"id\":1}",0) && !cJSONUtils_ValidateText(s,text,&fail) && fail>text);
+	cJSONUtils_FreeSchema(s);	cJSON_Delete(good);	cJSON_Delete(bad);	cJSON_Delete(def);
+
+	def=cJSON_Parse("{\"title\":\"t\",\"pattern\":\"^a\"}");
+	check("schema unknown keyword",!cJSONUtils_CompileSchema(def));
+	cJSON_Delete(def);
+}
+
+/* Short keys and strings live in the node when built with cJSON_INLINE_SIZE; longer ones, and changes, still work. */
+void inline_strings()
+{
+	cJSON *root=cJSON_Parse("{\"k\":\"short\",\"key\":\"a string too long to fit inside any node\"}"),*k=cJSON_GetObjectItem(root,"k");
+	char *out;
+
+#if cJSON_INLINE_SIZE > 0
+	check("inline short string",(k->type & cJSON_StringIsInline) && (k->type & cJSON_ValueIsInline));
+	check("inline long string",!(cJSON_GetObjectItem(root,"key")->type & cJSON_ValueIsInline));
+#endif
+	cJSON_SetValuestring(k,"now a much longer value than before");
+	cJSON_ReplaceItemInObject(root,"key",cJSON_CreateString("s"));
+	out=cJSON_PrintUnformatted(root);
+	check("inline strings changed",!strcmp(out,"{\"k\":\"now a much longer value than before\",\"key\":\"s\"}"));
+	free(out);	cJSON_Delete(root);
+}
+
+/* A frozen copy answers lookups the way the tree does. */
+void freeze()
+{
+	cJSON *root=cJSON_Parse("{\"b\":[10,20,30],\"A\":\"x\",\"c\":{\"d\":true}}");
+	const cJSON_Frozen *f=cJSON_Freeze(root),*b=cJSON_GetFrozenObjectItem(f,"b");
+
+	check("freeze",f && f->count==3 && b && b->count==3 && cJSON_GetFrozenArrayItem(b,2)->valueint==30
+		&& !strcmp(cJSON_GetFrozenObjectItem(f,"a")->valuestring,"x")
+		&& cJSON_GetFrozenObjectItem(cJSON_GetFrozenObjectItem(f,"c"),"d")->type==cJSON_True
+		&& !cJSON_GetFrozenObjectItem(f,"e") && !cJSON_GetFrozenArrayItem(b,3));
+	cJSON_FreeFrozen(f);	cJSON_Delete(root);
+}
+
+/* Numbers: integers round-trip exactly; in cJSON_NO_FLOAT builds a fraction keeps its text. */
+void numbers()
+{
+	cJSON *root=cJSON_Parse("[9007199254740993,-12,1.50,2e3]");
+	char *out=cJSON_PrintUnformatted(root);
+
+#ifdef cJSON_NO_FLOAT
+	check("numbers without float",!strcmp(out,"[9007199254740993,-12,1.50,2e3]") && cJSON_GetArrayItem(root,2)->valueint==1);
+#else
+	check("numbers",cJSON_GetArrayItem(root,1)->valueint==-12 && cJSON_GetArrayItem(root,2)->valuedouble==1.5
+		&& cJSON_GetArrayItem(root,3)->valuedouble==2000);
+#endif
+	free(out);	cJSON_Delete(root);
+}
+
+/* The plain editing calls on a tree parsed through a pooled context, mixing in nodes from the hooks. */
+void pool_mutate()
+{
+	cJSON_Context ctx;cJSON_Pool pool;cJSON *root;char *out;
+
+	cJSON_InitContext(&ctx);
+	cJSON_InitPool(&pool,&ctx,16);
+	root=cJSON_ParseWithContext(&ctx,"{\"a\":\"one\",\"b\":[1,2],\"c\":{\"d\":null}}",0);
+	cJSON_DeleteItemFromObject(root,"a");
+	cJSON_AddItemToObject(root,"e",cJSON_CreateString("new"));
+	cJSON_ReplaceItemInObject(root,"c",cJSON_CreateTrue());
+	cJSON_SetValuestring(cJSON_GetObjectItem(root,"e"),"newer");
+	cJSON_AddItemToArray(cJSON_GetObjectItem(root,"b"),cJSON_DetachItemFromObject(root,"e"));
+	out=cJSON_PrintUnformatted(root);
+	check("pooled tree edits",!strcmp(out,"{\"b\":[1,2,\"newer\"],\"c\":true}"));
+	free(out);	cJSON_Delete(root);
+
+	/* And the other way round: pooled nodes in a tree from the hooks go back to the pool. */
+	cJSON_TrimPool(&pool,0);
+	root=cJSON_CreateObject();
+	cJSON_AddItemToObject(root,"p",cJSON_ParseWithContext(&ctx,"[\"pooled\"]",0));
+	cJSON_DeleteWithContext(&ctx,root);
+	check("pooled nodes returned",pool.counts[2]+pool.counts[3]+pool.counts[4]>0);
+	cJSON_TrimPool(&pool,0);
+}
+
 int main (int argc, const char * argv[]) {
 	/* a bunch of json: */
 	char text1[]="{\n\"name\": \"Jack (\\\"Bee\\\") Nimble\", \n\"format\": {\"type\":       \"rect\", \n\"width\":      1920, \n\"height\":     1080, \n\"interlace\":  false,\"frame rate\": 24\n}\n}";	
@@ -157,6 +400,20 @@ int main (int argc, const char * argv[]) {
 
 	/* Now some samplecode for building objects concisely: */
 	create_objects();
-	
-	return 0;
+
+	pool_packed();
+
+	/* Behaviour checks: */
+	patch_roundtrip();
+	parse_length();
+	print_sink_parallel();
+	struct_codec();
+	ndjson();
+	schema();
+	inline_strings();
+	freeze();
+	numbers();
+	pool_mutate();
+
+	return failures?1:0;
 }